@@ -0,0 +1,105 @@
+import glob
+import os
+import subprocess
+import sys
+import threading
+import time
+
+import lightlog
+from lightlog import INFO, Logger
+
+# Configuration
+huge_page_modes = ["off", "transparent", "explicit"]
+num_threads = 4
+messages_per_thread = 200_000
+num_repeats = 3
+queue_capacity = 1 << 16
+log_message = "Log message {}"
+
+
+def numa_nodes():
+    """CPU lists of the NUMA nodes, from sysfs (Linux only); all usable CPUs without NUMA."""
+    nodes = []
+    for path in sorted(glob.glob("/sys/devices/system/node/node[0-9]*/cpulist"),
+                       key=lambda p: int(p.split("node")[-1].split("/")[0])):
+        cpus = []
+        with open(path) as f:
+            for part in f.read().strip().split(","):
+                if part:
+                    first, _, last = part.partition("-")
+                    cpus.extend(range(int(first), int(last or first) + 1))
+        if cpus:
+            nodes.append(cpus)
+    return nodes or [sorted(os.sched_getaffinity(0))]
+
+
+def child(mode, producer_node):
+    """Measure one setting; the rings and the writer live on node 0, the producers on `producer_node`."""
+    nodes = numa_nodes()
+    home, producers = nodes[0], nodes[producer_node]
+
+    # Console output would dominate the measurement, so send the process's stdout to the null device
+    console = os.dup(1)
+    devnull = os.open(os.devnull, os.O_WRONLY)
+    os.dup2(devnull, 1)
+
+    lightlog.configure_engine(queue_capacity=queue_capacity, cpu_affinity=home, huge_pages=mode)
+    os.sched_setaffinity(0, home)
+    logger = Logger("numa_logger", level=INFO, latency_budget=1e6)  # a budget this large never drops
+    logger.info("map the rings on node 0")
+    logger.flush()
+
+    def run():
+        barrier = threading.Barrier(num_threads + 1)
+
+        def worker(cpu):
+            os.sched_setaffinity(0, [cpu])
+            barrier.wait()
+            for i in range(messages_per_thread):
+                logger.info(log_message.format(i))
+
+        threads = [threading.Thread(target=worker, args=(producers[i % len(producers)],)) for i in range(num_threads)]
+        for thread in threads:
+            thread.start()
+        barrier.wait()
+        start = time.perf_counter()
+        for thread in threads:
+            thread.join()
+        logger.flush()
+        return time.perf_counter() - start
+
+    best = min(run() for _ in range(num_repeats))
+    logger.close()
+    os.dup2(console, 1)
+    os.close(devnull)
+    print(num_threads * messages_per_thread / best)
+
+
+if len(sys.argv) == 4 and sys.argv[1] == "--child":
+    child(sys.argv[2], int(sys.argv[3]))
+    sys.exit(0)
+
+if not hasattr(os, "sched_setaffinity"):
+    sys.exit("This benchmark needs Linux (os.sched_setaffinity and /sys/devices/system/node).")
+nodes = numa_nodes()
+placements = [("local", 0)] + ([("remote", 1)] if len(nodes) > 1 else [])
+
+# Benchmark: every setting runs in a fresh process, since the engine is configured once per process
+results = {}
+for mode in huge_page_modes:
+    for placement, node in placements:
+        output = subprocess.run([sys.executable, __file__, "--child", mode, str(node)],
+                                check=True, capture_output=True, text=True).stdout
+        results[mode, placement] = float(output.split()[-1])
+
+# Print results
+print(" NUMA / Huge Page Results ".center(48, "-"))
+print(f"NUMA nodes: {len(nodes)}")
+print(f"Threads: {num_threads}, messages per thread: {messages_per_thread}")
+print(f"Repeats (best of): {num_repeats}")
+print(f"{'Huge pages':>12}" + "".join(f"{placement + ' msg/s':>18}" for placement, _ in placements))
+for mode in huge_page_modes:
+    print(f"{mode:>12}" + "".join(f"{results[mode, placement]:>18,.0f}" for placement, _ in placements))
+if len(nodes) == 1:
+    print("Single NUMA node: only the local placement was measured.")
+print("-" * 48)
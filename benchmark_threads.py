@@ -0,0 +1,61 @@
+import os
+import sys
+import threading
+import time
+
+from lightlog import INFO, Logger
+
+# Configuration
+thread_counts = [1, 2, 4, 8, 16, 32]
+messages_per_thread = 50_000
+num_repeats = 3
+log_message = "Log message {}"
+log_file = "lightlog_threads.log"
+
+# Console output would dominate the measurement, so send the process's stdout to the null device
+console = os.dup(1)
+devnull = os.open(os.devnull, os.O_WRONLY)
+os.dup2(devnull, 1)
+
+light_logger = Logger("light_logger", log_file, mode='w', level=INFO)
+
+
+# Benchmark
+def run(num_threads):
+    barrier = threading.Barrier(num_threads + 1)
+
+    def worker():
+        barrier.wait()
+        for i in range(messages_per_thread):
+            light_logger.info(log_message.format(i))
+
+    threads = [threading.Thread(target=worker) for _ in range(num_threads)]
+    for thread in threads:
+        thread.start()
+    barrier.wait()
+    start = time.perf_counter()
+    for thread in threads:
+        thread.join()
+    return time.perf_counter() - start
+
+
+results = []
+for num_threads in thread_counts:
+    best = min(run(num_threads) for _ in range(num_repeats))
+    results.append((num_threads, num_threads * messages_per_thread / best))
+
+light_logger.close()
+os.dup2(console, 1)
+os.close(devnull)
+os.remove(log_file)
+
+# Print results
+gil_enabled = getattr(sys, "_is_gil_enabled", lambda: True)()
+print(" Thread Scaling Results ".center(48, "-"))
+print(f"Python: {sys.version.split()[0]} (GIL {'enabled' if gil_enabled else 'disabled'})")
+print(f"Messages per thread: {messages_per_thread}")
+print(f"Repeats (best of): {num_repeats}")
+print(f"{'Threads':>8} {'Messages/s':>14} {'Speedup':>10}")
+for num_threads, rate in results:
+    print(f"{num_threads:>8} {rate:>14,.0f} {rate / results[0][1]:>9.2f}x")
+print("-" * 48)
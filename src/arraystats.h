@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "logscan.h"
+
+/**
+ * @brief Summary statistics of a numeric array
+ *
+ * `min`, `max`, `mean` and `std` only cover finite elements; NaN and infinite values are counted instead.
+ */
+struct ArrayStats
+{
+    uint64_t count = 0; // finite elements
+    uint64_t nan = 0;
+    uint64_t inf = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double mean = 0.0;
+    double m2 = 0.0; // sum of squared deviations from the mean
+
+    [[nodiscard]] double std() const { return count ? std::sqrt(m2 / static_cast<double>(count)) : 0.0; }
+
+    /**
+     * @brief Merge statistics of a disjoint block (Chan et al. parallel variance)
+     */
+    void merge(const ArrayStats &other)
+    {
+        nan += other.nan;
+        inf += other.inf;
+        if (other.count == 0)
+            return;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        const double n = static_cast<double>(count), m = static_cast<double>(other.count);
+        const double delta = other.mean - mean;
+        mean += delta * m / (n + m);
+        m2 += other.m2 + delta * delta * n * m / (n + m);
+        count += other.count;
+    }
+};
+
+/**
+ * @brief Convert IEEE half and bfloat16 bit patterns to float
+ */
+inline float half_to_float(uint16_t h)
+{
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    uint32_t exp = (h >> 10) & 0x1fu, mant = h & 0x3ffu, bits;
+    if (exp == 0x1f)
+        bits = sign | 0x7f800000u | (mant << 13); // inf / NaN
+    else if (exp != 0)
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    else if (mant == 0)
+        bits = sign; // signed zero
+    else
+    {
+        // subnormal: renormalize
+        exp = 113;
+        while ((mant & 0x400u) == 0)
+        {
+            mant <<= 1;
+            --exp;
+        }
+        bits = sign | (exp << 23) | ((mant & 0x3ffu) << 13);
+    }
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+inline float bfloat16_to_float(uint16_t h)
+{
+    const uint32_t bits = static_cast<uint32_t>(h) << 16;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+/**
+ * @brief Statistics of `n` contiguous elements
+ *
+ * The block is small enough to stay in cache, so the mean and the squared deviations are
+ * computed in two tight passes that the compiler can vectorize.
+ */
+template <typename T, typename Convert>
+ArrayStats block_stats(const T *data, size_t n, Convert convert)
+{
+    ArrayStats s;
+    double sum = 0.0, lo = s.min, hi = s.max;
+    uint64_t finite = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double v = static_cast<double>(convert(data[i]));
+        if constexpr (std::numeric_limits<T>::is_integer)
+        {
+            sum += v;
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+        }
+        else
+        {
+            if (std::isnan(v))
+                ++s.nan;
+            else if (std::isinf(v))
+                ++s.inf;
+            else
+            {
+                sum += v;
+                lo = std::min(lo, v);
+                hi = std::max(hi, v);
+                ++finite;
+            }
+        }
+    }
+    s.count = std::numeric_limits<T>::is_integer ? n : finite;
+    if (s.count == 0)
+        return s;
+    s.min = lo;
+    s.max = hi;
+    s.mean = sum / static_cast<double>(s.count);
+    double m2 = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double v = static_cast<double>(convert(data[i]));
+        if (std::numeric_limits<T>::is_integer || std::isfinite(v))
+            m2 += (v - s.mean) * (v - s.mean);
+    }
+    s.m2 = m2;
+    return s;
+}
+
+/**
+ * @brief Statistics of a (possibly strided) array of element type `T`
+ *
+ * @param shape Extent of every dimension
+ * @param strides Stride of every dimension in elements
+ * @param threads Worker threads for large contiguous arrays (0 = hardware concurrency)
+ */
+template <typename T, typename Convert>
+ArrayStats array_stats(const T *data, const std::vector<size_t> &shape, const std::vector<int64_t> &strides,
+                       unsigned threads, Convert convert)
+{
+    constexpr size_t kBlock = 1 << 16;           // elements per cache-resident block
+    constexpr size_t kParallelThreshold = 1 << 20; // below this, threads cost more than they save
+
+    size_t total = 1;
+    for (size_t extent : shape)
+        total *= extent;
+    if (total == 0)
+        return {};
+
+    bool contiguous = true;
+    int64_t expected = 1;
+    for (size_t d = shape.size(); d-- > 0;)
+    {
+        if (shape[d] != 1 && strides[d] != expected)
+            contiguous = false;
+        expected *= static_cast<int64_t>(shape[d]);
+    }
+
+    ArrayStats result;
+    if (contiguous)
+    {
+        const size_t blocks = (total + kBlock - 1) / kBlock;
+        std::vector<ArrayStats> partial(blocks);
+        auto run = [&](size_t b)
+        { partial[b] = block_stats(data + b * kBlock, std::min(kBlock, total - b * kBlock), convert); };
+        if (total >= kParallelThreshold)
+            parallel_for(blocks, threads, run);
+        else
+            for (size_t b = 0; b < blocks; ++b)
+                run(b);
+        for (const ArrayStats &p : partial)
+            result.merge(p);
+        return result;
+    }
+
+    // Strided view: walk the outer dimensions with an odometer and treat each innermost row as a block
+    const size_t ndim = shape.size();
+    const size_t inner = shape[ndim - 1];
+    const int64_t inner_stride = strides[ndim - 1];
+    std::vector<size_t> index(ndim, 0);
+    std::vector<T> row(inner);
+    while (true)
+    {
+        const T *p = data;
+        for (size_t d = 0; d + 1 < ndim; ++d)
+            p += static_cast<int64_t>(index[d]) * strides[d];
+        for (size_t i = 0; i < inner; ++i)
+            row[i] = p[static_cast<int64_t>(i) * inner_stride];
+        result.merge(block_stats(row.data(), inner, convert));
+
+        size_t d = ndim - 1;
+        while (d-- > 0)
+        {
+            if (++index[d] < shape[d])
+                break;
+            index[d] = 0;
+        }
+        if (d == static_cast<size_t>(-1))
+            break;
+    }
+    return result;
+}
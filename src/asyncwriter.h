@@ -0,0 +1,444 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ringmemory.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Bounded multi-producer queues of formatted records, drained by a pool of writer threads
+ *
+ * Records are sharded by the producer's choice of key, and the records of one shard are
+ * written in the order they were queued; records of different shards are not ordered. Each
+ * shard has two lanes, and its priority lane is emptied before the next record of its normal
+ * lane, so an error is written right away even behind a backlog of normal records.
+ *
+ * Producers claim a slot with a single compare-and-swap (Vyukov's bounded queue) and copy the
+ * record into it. Slots keep the capacity of their strings, so a warmed-up handoff does not
+ * allocate. A lane's ring is mapped and initialized by the first producer that pushes to it, so
+ * first-touch places it on that producer's NUMA node, and large rings can be backed by huge
+ * pages. A producer that finds the lane full keeps retrying only until its time budget is
+ * spent and then gives up, so a slow disk or a blocked stdout pipe delays a writer thread,
+ * never the caller.
+ *
+ * A shard is drained by one thread at a time. Every thread serves its home shards first and
+ * then steals whichever other shard no thread holds, so a hot or slow file keeps one thread
+ * busy while the remaining files move on. A thread that runs out of work keeps polling for
+ * the spin budget and then parks on a condition variable until a record arrives or the idle
+ * hook's next deadline; producers only signal while a thread is parked, so under a steady
+ * stream of records they make no system call at all, and an idle pool does not wake up.
+ */
+class AsyncWriter
+{
+public:
+    struct Record
+    {
+        void *owner = nullptr;          // the logger that formatted the record
+        const void *settings = nullptr; // the owner's settings it was formatted with, kept alive by the owner
+        int level = 0;
+        bool console = true; // also write it to the console (false for lines already shown in place)
+        std::string text;
+        std::string new_file;
+    };
+
+    /**
+     * @brief The two lanes of a shard: `kPriority` is emptied before the next `kNormal` record
+     */
+    enum Lane
+    {
+        kNormal = 0,
+        kPriority = 1,
+    };
+
+    using WriteFn = void (*)(Record &record, Lane lane);
+    using Clock = std::chrono::steady_clock;
+    using IdleFn = Clock::time_point (*)(); // returns when to be called again, `Clock::time_point::max()` for never
+    using StartFn = void (*)();
+
+    /**
+     * @param threads Number of writer threads (at least 1)
+     * @param shards Number of shards (at least `threads`)
+     * @param capacity Number of slots of each normal lane, rounded up to a power of two
+     * @param priority_capacity Number of slots of each priority lane, rounded up to a power of two
+     * @param write Called on a writer thread for every record, in queue order within each lane of a shard
+     * @param idle Called on a writer thread whenever it found every shard empty; the thread parks
+     *             at most until the time it returns
+     * @param start Called first on every writer thread, e.g. to set its CPU affinity
+     * @param spin How long a thread keeps polling empty shards before it parks (0 parks at once)
+     * @param huge_pages Backing of the rings
+     */
+    AsyncWriter(size_t threads, size_t shards, size_t capacity, size_t priority_capacity, WriteFn write, IdleFn idle,
+                StartFn start, std::chrono::nanoseconds spin, HugePages huge_pages)
+        : write_(write), idle_(idle), start_(start), spin_(spin)
+    {
+        threads = std::max<size_t>(threads, 1);
+        shards = std::max(shards, threads);
+        for (size_t i = 0; i < shards; ++i)
+            shards_.push_back(std::make_unique<Shard>(capacity, priority_capacity, huge_pages));
+        for (size_t i = 0; i < threads; ++i)
+            threads_.emplace_back([this, i, threads] { run(i, threads); });
+    }
+
+    ~AsyncWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto &thread : threads_)
+            thread.join();
+    }
+
+    AsyncWriter(const AsyncWriter &) = delete;
+    AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+    [[nodiscard]] size_t shard_count() const { return shards_.size(); }
+
+    /**
+     * @brief Hand a record to the writer threads, giving up once the lane stayed full for `budget`
+     *
+     * The first push to a lane maps and initializes its ring on the calling thread, which can
+     * take longer than `budget`: the budget only bounds the wait for a free slot.
+     *
+     * @param shard Any number; records with the same `shard % shard_count()` are written in order
+     * @return false if the record was dropped
+     */
+    bool try_push(size_t shard, Lane lane, void *owner, const void *settings, int level, std::string_view text,
+                  const std::string &new_file, std::chrono::nanoseconds budget, bool console = true)
+    {
+        Queue &queue = shards_[shard % shards_.size()]->lanes[lane];
+        Slot *slots = queue.slots.load(std::memory_order_acquire);
+        if (!slots)
+            slots = queue.map();
+        size_t pos = queue.enqueue_pos.load(std::memory_order_relaxed);
+        std::chrono::steady_clock::time_point deadline{};
+        Slot *slot;
+        while (true)
+        {
+            slot = &slots[pos & queue.mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (queue.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // Full: the clock is only read once the queue pushes back
+                const auto now = std::chrono::steady_clock::now();
+                if (deadline == std::chrono::steady_clock::time_point{})
+                    deadline = now + budget;
+                else if (now >= deadline)
+                    return false;
+                pos = queue.enqueue_pos.load(std::memory_order_relaxed);
+            }
+            else
+                pos = queue.enqueue_pos.load(std::memory_order_relaxed);
+        }
+
+        Record &record = slot->record;
+        record.owner = owner;
+        record.settings = settings;
+        record.level = level;
+        record.console = console;
+        record.text.assign(text.data(), text.size());
+        record.new_file.assign(new_file);
+        slot->sequence.store(pos + 1); // sequentially consistent, paired with `parked_` in `run()`
+
+        if (parked_.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_.notify_one();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Wait until every record pushed to any shard before the call has been written
+     */
+    void drain()
+    {
+        std::vector<size_t> targets;
+        for (const auto &shard : shards_)
+            for (const Queue &queue : shard->lanes)
+                targets.push_back(queue.enqueue_pos.load());
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++drain_waiters_;
+        wake_.notify_all();
+        drained_.wait(lock,
+                      [&]
+                      {
+                          size_t i = 0;
+                          for (const auto &shard : shards_)
+                              for (const Queue &queue : shard->lanes)
+                                  if (queue.written.load() < targets[i++])
+                                      return false;
+                          return true;
+                      });
+        --drain_waiters_;
+    }
+
+    /**
+     * @brief Whether the caller is one of the writer threads, which must never `drain()`
+     */
+    [[nodiscard]] static bool on_writer_thread() { return writer_thread_; }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<size_t> sequence{0};
+        Record record;
+    };
+
+    struct Queue
+    {
+        Queue(size_t capacity, HugePages huge_pages) : huge_pages(huge_pages)
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+            mask = size - 1;
+        }
+
+        ~Queue()
+        {
+            if (Slot *ring = slots.load())
+            {
+                for (size_t i = 0; i <= mask; ++i)
+                    ring[i].~Slot();
+            }
+        }
+
+        /**
+         * @brief Map and initialize the ring on the calling producer's thread (once per lane)
+         */
+        Slot *map()
+        {
+            std::lock_guard<std::mutex> lock(map_mutex);
+            if (Slot *ring = slots.load(std::memory_order_relaxed))
+                return ring;
+            memory = RingMemory((mask + 1) * sizeof(Slot), huge_pages);
+            auto *ring = static_cast<Slot *>(memory.data());
+            for (size_t i = 0; i <= mask; ++i)
+            {
+                new (&ring[i]) Slot{}; // the first touch of each page
+                ring[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            slots.store(ring, std::memory_order_release);
+            return ring;
+        }
+
+        /**
+         * @brief The next record if it has been published (called by the thread holding the shard)
+         */
+        Slot *ready()
+        {
+            Slot *ring = slots.load(std::memory_order_acquire);
+            if (!ring)
+                return nullptr;
+            Slot &slot = ring[read_pos & mask];
+            return slot.sequence.load() == read_pos + 1 ? &slot : nullptr;
+        }
+
+        void release(Slot &slot)
+        {
+            slot.sequence.store(read_pos + mask + 1, std::memory_order_release);
+            written.store(++read_pos);
+        }
+
+        [[nodiscard]] bool empty() const { return enqueue_pos.load() == written.load(); }
+
+        size_t mask = 0;
+        HugePages huge_pages;
+        std::atomic<Slot *> slots{nullptr}; // mapped on the first push, see `map()`
+        RingMemory memory;
+        std::mutex map_mutex;
+        size_t read_pos = 0; // touched by the thread holding the shard only
+        alignas(64) std::atomic<size_t> enqueue_pos{0};
+        alignas(64) std::atomic<size_t> written{0}; // records written so far
+    };
+
+    struct Shard
+    {
+        Shard(size_t capacity, size_t priority_capacity, HugePages huge_pages)
+            : lanes{Queue(capacity, huge_pages), Queue(priority_capacity, huge_pages)}
+        {
+        }
+
+        Queue lanes[2];
+        alignas(64) std::atomic<bool> held{false}; // a thread is draining the shard
+    };
+
+    /**
+     * @brief Write up to a batch of records of `shard`, unless another thread holds it
+     *
+     * The `held` flag is what keeps records of one shard in order: its acquire/release pair
+     * also hands `read_pos` from one thread to the next.
+     *
+     * @return The number of records written
+     */
+    size_t drain_shard(Shard &shard)
+    {
+        constexpr size_t kBatch = 64; // bounds how long one hot shard keeps a thread from the others
+        if (shard.held.load(std::memory_order_relaxed) || shard.held.exchange(true, std::memory_order_acquire))
+            return 0;
+        size_t count = 0;
+        for (; count < kBatch; ++count)
+        {
+            Lane lane = kPriority;
+            Slot *slot = shard.lanes[kPriority].ready();
+            if (!slot)
+            {
+                lane = kNormal;
+                slot = shard.lanes[kNormal].ready();
+            }
+            if (!slot)
+                break;
+            write_(slot->record, lane);
+            shard.lanes[lane].release(*slot);
+        }
+        shard.held.store(false, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Whether no shard has records left (`free_only`: none that another thread could pick up)
+     *
+     * A held shard is left out with `free_only`, so a thread does not spin on a hot shard its
+     * holder already drains; the holder scans again after releasing it.
+     */
+    [[nodiscard]] bool empty(bool free_only = false) const
+    {
+        return std::all_of(shards_.begin(), shards_.end(),
+                           [free_only](const auto &shard)
+                           {
+                               return (free_only && shard->held.load()) ||
+                                      (shard->lanes[kNormal].empty() && shard->lanes[kPriority].empty());
+                           });
+    }
+
+    static void cpu_relax()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    /**
+     * @brief Poll for work until the spin budget is spent, without announcing a park
+     *
+     * @return true if a shard received work meanwhile
+     */
+    bool spin_for_work() const
+    {
+        if (spin_.count() <= 0)
+            return false;
+        const auto deadline = std::chrono::steady_clock::now() + spin_;
+        while (true)
+        {
+            for (int i = 0; i < 64; ++i) // the clock is read once per round of polls
+            {
+                if (!empty(true))
+                    return true;
+                cpu_relax();
+            }
+            if (stopping_.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= deadline)
+                return false;
+        }
+    }
+
+    void run(size_t index, size_t threads)
+    {
+        writer_thread_ = true;
+        if (start_)
+            start_();
+        const size_t count = shards_.size();
+        bool spun = false; // the last empty round already spun, so the next one parks
+        auto next_idle = Clock::time_point::max();
+        while (true)
+        {
+            // Home shards (index, index + threads, ...) first, then any other shard nobody holds
+            size_t written = 0;
+            for (size_t i = index; i < count; i += threads)
+                written += drain_shard(*shards_[i]);
+            for (size_t k = 1; k < count; ++k)
+            {
+                const size_t i = (index + k) % count;
+                if (i % threads != index)
+                    written += drain_shard(*shards_[i]);
+            }
+            if (written)
+            {
+                spun = false;
+                if (drain_waiters_.load())
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    drained_.notify_all();
+                }
+                continue;
+            }
+
+            if (!spun)
+            {
+                next_idle = idle_();
+                spun = true;
+                if (spin_for_work())
+                    continue;
+            }
+            spun = false;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            drained_.notify_all();
+            if (stopping_ && empty())
+                return;
+            // Announce the park before the last look, so a producer either sees the count or
+            // published its record before this check
+            parked_.fetch_add(1);
+            if (empty(true) && !stopping_)
+            {
+                if (next_idle == Clock::time_point::max())
+                    wake_.wait(lock);
+                else
+                    wake_.wait_until(lock, next_idle);
+            }
+            parked_.fetch_sub(1);
+        }
+    }
+
+    static inline thread_local bool writer_thread_ = false;
+
+    WriteFn write_;
+    IdleFn idle_;
+    StartFn start_;
+    std::chrono::nanoseconds spin_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<int> parked_{0};
+    std::atomic<int> drain_waiters_{0};
+    std::mutex mutex_; // pairs with both condition variables
+    std::condition_variable wake_, drained_;
+    std::atomic<bool> stopping_{false}; // set under `mutex_`, read without it while spinning
+    std::vector<std::thread> threads_;
+};
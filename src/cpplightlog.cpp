@@ -1,110 +1,2053 @@
 #include <nanobind/nanobind.h>
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/tuple.h>
+#include <nanobind/stl/vector.h>
+#include <nanobind/ndarray.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <chrono>
 #include <filesystem>
 #include <unordered_map>
+#include <unordered_set>
 #include <optional>
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+#include "arraystats.h"
+#include "asyncwriter.h"
+#include "epoch.h"
+#include "levels.h"
+#include "logscan.h"
+#include "metrics.h"
+#include "threadpolicy.h"
 
 namespace nb = nanobind;
 namespace fs = std::filesystem;
 
 /**
- * @brief A C++ logger class that provides core logging functionality for `LightLog`
+ * @brief An immutable frame of contextual fields (MDC) shared by all loggers
  *
- * This class implements a logging workflow that can output to both console and file.
- * It supports rank-based logging for distributed systems and various log levels.
+ * Frames are stacked through a `contextvars.ContextVar`, so they follow threads and asyncio
+ * tasks. Each frame holds the merged fields of its parents and is rendered once, when it
+ * is pushed; logging a line only copies `rendered`.
  */
-class CppLogger : public std::streambuf
+class LogContext
 {
 public:
+    LogContext(const LogContext *parent, const nb::dict &fields)
+    {
+        if (parent)
+            fields_ = parent->fields_;
+        for (auto [key, value] : fields)
+        {
+            std::string k = nb::cast<std::string>(nb::str(key)), v = nb::cast<std::string>(nb::str(value));
+            auto it = std::find_if(fields_.begin(), fields_.end(), [&](const auto &field) { return field.first == k; });
+            if (it != fields_.end())
+                it->second = std::move(v);
+            else
+                fields_.emplace_back(std::move(k), std::move(v));
+        }
+        for (const auto &[key, value] : fields_)
+        {
+            if (!rendered_.empty())
+                rendered_ += ' ';
+            rendered_.append(key).append("=").append(value);
+        }
+        if (!rendered_.empty())
+            rendered_.append(" | ");
+    }
+
+    [[nodiscard]] const std::vector<std::pair<std::string, std::string>> &fields() const { return fields_; }
+    [[nodiscard]] const std::string &rendered() const { return rendered_; }
+
     /**
-     * @brief Construct a new CppLogger object
-     *
-     * @param name The name of the logger
-     * @param file_path Path to the log file (optional)
-     * @param mode File opening mode (default: "a" for append)
-     * @param level Logging level (default: 20 for INFO)
-     * @param use_rank Whether to use rank-based logging (default: false)
-     * @param rank Process rank for distributed logging (default: 0)
-     * @param world_size Total number of processes (default: 1)
-     * @param auto_detect_env Environment for auto-detecting rank and world size (default: "none")
+     * @brief The `contextvars.ContextVar` holding the current frame (None when empty)
      */
-    CppLogger(const std::string &name,
-              const std::string &file_path = "",
-              const std::string &mode = "a",
-              int level = 0,
-              bool use_rank = false,
-              int rank = 0,
-              int world_size = 1,
-              const std::string &auto_detect_env = "none",
-              int log_rank = -1)
-        : name_(name), file_path_(file_path), mode_(mode), level_(level),
-          use_rank_(use_rank), rank_(rank), world_size_(world_size), log_rank_(log_rank)
+    static nb::handle var() { return var_; }
+
+    /**
+     * @brief Create the context variable (called once from the module init, under the GIL)
+     */
+    static void init()
     {
-        if (use_rank_)
-            std::tie(rank_, world_size_) = get_rank_and_world_size(rank, world_size, auto_detect_env);
-        if (!file_path_.empty())
-            open_file();
+        // Intentionally leaked: it must outlive every logger, including those destroyed at shutdown
+        var_ = nb::module_::import_("contextvars").attr("ContextVar")("lightlog_context", nb::arg("default") = nb::none()).release();
     }
 
     /**
-     * @brief Destroy the CppLogger object
+     * @brief The frame active in the calling thread/task, kept alive by the returned object
+     */
+    static nb::object current() { return get(var()); }
+
+    /**
+     * @brief Value of a `contextvars.ContextVar` whose default is None
+     */
+    static nb::object get(nb::handle var)
+    {
+        PyObject *value = nullptr;
+#ifdef Py_LIMITED_API
+        value = PyObject_CallMethod(var.ptr(), "get", nullptr);
+#else
+        if (PyContextVar_Get(var.ptr(), nullptr, &value) < 0)
+            value = nullptr;
+#endif
+        if (!value)
+        {
+            PyErr_Clear();
+            return nb::none();
+        }
+        return nb::steal(value);
+    }
+
+    [[nodiscard]] static const LogContext *from(const nb::handle &frame)
+    {
+        if (!nb::isinstance<nb::capsule>(frame))
+            return nullptr;
+        return static_cast<const LogContext *>(nb::borrow<nb::capsule>(frame).data());
+    }
+
+private:
+    static inline nb::handle var_;
+
+    std::vector<std::pair<std::string, std::string>> fields_;
+    std::string rendered_; // "key=value key2=value2 | ", or empty
+};
+
+/**
+ * @brief `sys.stdout` replacement that sends `print()` output to the logger bound in the current context
+ *
+ * The router is installed once; binding a logger only sets a `contextvars.ContextVar`, so it
+ * never swaps `sys.stdout` and other threads keep printing to the original stream. A frame
+ * remembers whether anything was written, so unbinding flushes the logger only after output.
+ */
+class PrintRouter
+{
+public:
+    struct Frame
+    {
+        nb::object target;
+        std::atomic<bool> written{false}; // the frame may be shared by tasks running in other threads
+    };
+
+    /**
+     * @brief Bind `target` (anything with `write` and `flush`) in the calling thread/task
      *
-     * Ensures all buffered data is flushed and files are closed.
+     * @return The `contextvars.Token` that `pop` needs to restore the previous binding
      */
-    ~CppLogger()
+    static nb::object push(nb::handle target)
     {
-        flush();
-        close();
+        install();
+        auto *frame = new Frame{nb::borrow<nb::object>(target)};
+        nb::capsule owner(frame, [](void *p) noexcept
+                          { delete static_cast<Frame *>(p); });
+        return var().attr("set")(owner);
     }
 
     /**
-     * @brief Flush the logger, writing any buffered data
+     * @brief Restore the binding that was active before the matching `push`
+     */
+    static void pop(nb::handle token)
+    {
+        nb::object current = LogContext::get(var());
+        var().attr("reset")(token);
+        if (Frame *frame = from(current); frame && frame->written.load(std::memory_order_relaxed))
+            frame->target.attr("flush")();
+    }
+
+    /**
+     * @brief Stop sending unrouted output to `stream`, e.g. when a logger undoes `redirect_print`
+     *
+     * For a `stream` that is `sys.stdout` itself, the caller restores `sys.stdout` instead. When
+     * no replaced stream is left, output falls back to `previous` (unless that is the router),
+     * then to `sys.__stdout__`.
      */
+    static void release_stream(nb::handle stream, nb::handle previous)
+    {
+        nb::object fallback = !previous.is(self_) && !previous.is_none() ? nb::borrow<nb::object>(previous)
+                                                                         : nb::object(sys_.attr("__stdout__"));
+        std::vector<nb::object> removed; // released after the lock: their destructors may print
+        std::lock_guard<std::mutex> lock(router_->mutex_);
+        auto &streams = router_->streams_;
+        for (auto it = streams.begin(); it != streams.end();)
+        {
+            if (it->is(stream))
+            {
+                removed.push_back(std::move(*it));
+                it = streams.erase(it);
+            }
+            else
+                ++it;
+        }
+        if (streams.empty() && !removed.empty())
+            streams.push_back(std::move(fallback));
+    }
+
+    nb::object write(nb::handle text)
+    {
+        nb::object current = LogContext::get(var());
+        if (Frame *frame = from(current))
+        {
+            frame->written.store(true, std::memory_order_relaxed);
+            return frame->target.attr("write")(text);
+        }
+        nb::object stream = replaced();
+        return !stream.is_none() ? nb::object(stream.attr("write")(text)) : nb::none();
+    }
+
     void flush()
     {
-        if (file_.is_open())
-            file_.flush();
-        std::cout.flush();
+        nb::object current = LogContext::get(var());
+        if (Frame *frame = from(current))
+            frame->target.attr("flush")();
+        else if (nb::object stream = replaced(); !stream.is_none())
+            stream.attr("flush")();
+    }
+
+    /**
+     * @brief Everything else (`encoding`, `isatty`, `fileno`, ...) comes from the replaced stream
+     */
+    nb::object getattr(nb::handle name) { return replaced().attr(name); }
+
+    /**
+     * @brief Create the router and its context variable (called once from the module init, under the GIL)
+     */
+    static void init()
+    {
+        // Intentionally leaked, like the context variable of `LogContext`
+        var_ = nb::module_::import_("contextvars").attr("ContextVar")("lightlog_print_target", nb::arg("default") = nb::none()).release();
+        sys_ = nb::module_::import_("sys").release();
+        router_ = new PrintRouter();
+        self_ = nb::cast(router_, nb::rv_policy::reference).release();
+    }
+
+private:
+    static nb::handle var() { return var_; }
+
+    /**
+     * @brief The stream unrouted output goes to: the last one the router replaced (None before any)
+     */
+    nb::object replaced()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !streams_.empty() ? streams_.back() : nb::none();
+    }
+
+    static Frame *from(const nb::handle &frame)
+    {
+        if (!nb::isinstance<nb::capsule>(frame))
+            return nullptr;
+        return static_cast<Frame *>(nb::borrow<nb::capsule>(frame).data());
+    }
+
+    /**
+     * @brief Make the router `sys.stdout`, remembering the stream it replaces
+     *
+     * Checked on every `push` so the router comes back after something else replaced
+     * `sys.stdout`. Replaced streams are stacked rather than overwritten, so a logger that
+     * had been made `sys.stdout` by `redirect_print` can later be taken out again by
+     * `release_stream` while the streams below it stay.
+     */
+    static void install()
+    {
+        nb::object stdout_ = sys_.attr("stdout");
+        if (stdout_.is(self_))
+            return;
+        {
+            std::lock_guard<std::mutex> lock(router_->mutex_);
+            auto &streams = router_->streams_;
+            if (streams.empty() || !streams.back().is(stdout_))
+                streams.push_back(stdout_);
+        }
+        if (PyObject_SetAttrString(sys_.ptr(), "stdout", self_.ptr()) < 0)
+            throw nb::python_error();
+    }
+
+    static inline nb::handle var_, sys_, self_;
+    static inline PrintRouter *router_ = nullptr; // leaked with the Python objects it holds
+
+    std::mutex mutex_;                // guards `streams_`; no Python code runs while it is held
+    std::vector<nb::object> streams_; // the `sys.stdout`s the router replaced, most recent last
+};
+
+/**
+ * @brief Renders the `file:line:function` location of the Python code that called the logger
+ *
+ * The `file:` and `:function` parts are cached per code object, so capturing a location costs
+ * a frame lookup, a hash lookup, a weak-reference check and the formatting of the line number.
+ * Frames executing code of the `lightlog` package itself are skipped, so the location is the
+ * user's call site.
+ */
+class CallerLocation
+{
+public:
+    /**
+     * @brief Append the caller's `file:line:function | ` to `out` (nothing if there is no Python frame)
+     */
+    static void render(std::string &out)
+    {
+        PyFrameObject *frame = PyEval_GetFrame(); // borrowed
+        nb::object owner;                        // keeps frames reached through f_back alive
+        while (frame)
+        {
+            const std::shared_ptr<const Entry> entry = lookup(frame);
+            if (!entry->internal)
+            {
+                char line_buf[16];
+                snprintf(line_buf, sizeof(line_buf), "%d", PyFrame_GetLineNumber(frame));
+                out.append(entry->file).append(":").append(line_buf).append(":").append(entry->function).append(" | ");
+                return;
+            }
+            owner = back(frame);
+            frame = owner.is_none() ? nullptr : reinterpret_cast<PyFrameObject *>(owner.ptr());
+        }
+    }
+
+    /**
+     * @brief Remember the extension module so the package directory can be found lazily
+     */
+    static void set_module(nb::handle module) { module_ = module; }
+
+    struct Entry
+    {
+        nb::object ref; // weak reference to the code object, which tells a reused cache key apart
+        std::string path, file, function;
+        bool internal;
+    };
+
+    /**
+     * @brief Cached names of the code object a frame is executing
+     *
+     * The cache holds code objects only weakly, so code compiled by `exec` or a reloaded
+     * module can still be freed. Entries of freed code are swept once the cache is full.
+     */
+    static std::shared_ptr<const Entry> lookup(PyFrameObject *frame)
+    {
+#if PY_VERSION_HEX >= 0x03090000
+        nb::object code = nb::steal(reinterpret_cast<PyObject *>(PyFrame_GetCode(frame)));
+#else
+        nb::object code = nb::borrow(reinterpret_cast<PyObject *>(frame->f_code));
+#endif
+        Cache &cache = Cache::instance();
+        {
+            std::shared_lock<std::shared_mutex> lock(cache.mutex);
+            auto it = cache.entries.find(code.ptr());
+            if (it != cache.entries.end() && refers_to(it->second->ref, code.ptr()))
+                return it->second;
+        }
+
+        // Resolve the names without holding the lock; a racing thread may insert the same entry first
+        std::string path = nb::cast<std::string>(code.attr("co_filename"));
+        std::string function = nb::cast<std::string>(code.attr("co_name"));
+        const bool internal = !package_dir().empty() && path.compare(0, package_dir().size(), package_dir()) == 0;
+        std::string file = fs::path(path).filename().string();
+        nb::object ref = nb::steal(PyWeakref_NewRef(code.ptr(), nullptr));
+        if (!ref.is_valid())
+            throw nb::python_error();
+        auto entry = std::make_shared<const Entry>(Entry{std::move(ref), std::move(path), std::move(file), std::move(function), internal});
+
+        std::unique_lock<std::shared_mutex> lock(cache.mutex);
+        if (cache.entries.size() >= Cache::kMaxEntries)
+        {
+            for (auto it = cache.entries.begin(); it != cache.entries.end();)
+                it = refers_to(it->second->ref, it->first) ? std::next(it) : cache.entries.erase(it);
+            if (cache.entries.size() >= Cache::kMaxEntries)
+                cache.entries.clear(); // callers keep their entries alive through the shared pointers
+        }
+        cache.entries[code.ptr()] = entry;
+        return entry;
+    }
+
+private:
+    struct Cache
+    {
+        static constexpr size_t kMaxEntries = 4096;
+
+        // Leaked, like the `EpochDomain`: the entries hold Python objects that must not be
+        // released after the interpreter has finalized
+        static Cache &instance()
+        {
+            static auto *cache = new Cache();
+            return *cache;
+        }
+
+        std::shared_mutex mutex; // guards `entries`
+        std::unordered_map<PyObject *, std::shared_ptr<const Entry>> entries;
+    };
+
+    /**
+     * @brief Whether the weak reference `ref` still points to `object`
+     */
+    static bool refers_to(const nb::object &ref, PyObject *object)
+    {
+#if PY_VERSION_HEX >= 0x030D0000
+        PyObject *target = nullptr;
+        if (PyWeakref_GetRef(ref.ptr(), &target) < 0)
+        {
+            PyErr_Clear();
+            return false;
+        }
+        Py_XDECREF(target); // only compared, never dereferenced
+        return target == object;
+#else
+        return PyWeakref_GetObject(ref.ptr()) == object;
+#endif
+    }
+
+    static nb::object back(PyFrameObject *frame)
+    {
+#if defined(Py_LIMITED_API) || PY_VERSION_HEX < 0x03090000
+        return nb::steal(PyObject_GetAttrString(reinterpret_cast<PyObject *>(frame), "f_back"));
+#else
+        PyFrameObject *prev = PyFrame_GetBack(frame);
+        return prev ? nb::steal(reinterpret_cast<PyObject *>(prev)) : nb::none();
+#endif
+    }
+
+    static const std::string &package_dir()
+    {
+        static const std::string dir = []
+        {
+            if (!module_.is_valid() || !nb::hasattr(module_, "__file__"))
+                return std::string();
+            fs::path file(nb::cast<std::string>(module_.attr("__file__")));
+            return (file.parent_path() / "").string();
+        }();
+        return dir;
+    }
+
+    static inline nb::handle module_;
+};
+
+/**
+ * @brief Renders an exception and its traceback in the layout of `traceback.print_exception`
+ *
+ * Frames are rendered from the per-code-object cache of `CallerLocation`; source lines are
+ * not read. Chained exceptions (`__cause__` / `__context__`) are rendered first, as Python does.
+ */
+class ExceptionFormatter
+{
+public:
+    /**
+     * @brief The exception currently being handled, or None
+     */
+    static nb::object current()
+    {
+#if PY_VERSION_HEX >= 0x030C0000
+        PyObject *exc = PyErr_GetHandledException();
+        return exc ? nb::steal(exc) : nb::none();
+#else
+        nb::tuple info = nb::borrow<nb::tuple>(nb::module_::import_("sys").attr("exc_info")());
+        return nb::borrow<nb::object>(info[1]);
+#endif
+    }
+
+    static void render(nb::handle exc, std::string &out)
+    {
+        std::vector<PyObject *> seen;
+        render_chain(exc, out, seen);
+    }
+
+private:
+    static void render_chain(nb::handle exc, std::string &out, std::vector<PyObject *> &seen)
+    {
+        seen.push_back(exc.ptr());
+        nb::object cause = exc.attr("__cause__");
+        nb::object context = exc.attr("__context__");
+        if (!cause.is_none() && std::find(seen.begin(), seen.end(), cause.ptr()) == seen.end())
+        {
+            render_chain(cause, out, seen);
+            out.append("\nThe above exception was the direct cause of the following exception:\n\n");
+        }
+        else if (cause.is_none() && !context.is_none() && !nb::cast<bool>(exc.attr("__suppress_context__")) &&
+                 std::find(seen.begin(), seen.end(), context.ptr()) == seen.end())
+        {
+            render_chain(context, out, seen);
+            out.append("\nDuring handling of the above exception, another exception occurred:\n\n");
+        }
+
+        nb::object tb = exc.attr("__traceback__");
+        if (!tb.is_none())
+            out.append("Traceback (most recent call last):\n");
+        char line_buf[16];
+        while (!tb.is_none())
+        {
+            nb::object frame = tb.attr("tb_frame");
+            const auto entry = CallerLocation::lookup(reinterpret_cast<PyFrameObject *>(frame.ptr()));
+            snprintf(line_buf, sizeof(line_buf), "%d", nb::cast<int>(tb.attr("tb_lineno")));
+            out.append("  File \"").append(entry->path).append("\", line ").append(line_buf).append(", in ").append(entry->function).append("\n");
+            tb = tb.attr("tb_next");
+        }
+
+        nb::handle type = exc.type();
+        std::string module = nb::cast<std::string>(type.attr("__module__"));
+        if (module != "builtins" && module != "__main__")
+            out.append(module).append(".");
+        out.append(nb::cast<std::string>(type.attr("__qualname__")));
+        std::string text = nb::cast<std::string>(nb::str(exc));
+        if (!text.empty())
+            out.append(": ").append(text);
+        out.append("\n");
+    }
+};
+
+/**
+ * @brief Renders the `pid=… tid=… thread=… | ` identity fields of the calling thread
+ *
+ * The rendering is cached in a thread-local buffer, so a line only compares two integers
+ * and copies the cached text. The cache is invalidated for every thread when a Python thread
+ * is renamed (`invalidate()`, called from the `threading.Thread.name` hook installed by
+ * `Logger`) and in the child after `fork()`.
+ */
+class ThreadIdentity
+{
+public:
+    enum Field : unsigned
+    {
+        kPid = 1u << 0,
+        kTid = 1u << 1,
+        kThread = 1u << 2,
+    };
+
+    /**
+     * @brief Parse a comma-separated list of `pid`, `tid` and `thread` into a field mask
+     */
+    static unsigned parse(std::string_view names)
+    {
+        unsigned mask = 0;
+        while (!names.empty())
+        {
+            size_t comma = names.find(',');
+            std::string_view name = names.substr(0, comma);
+            names = comma == std::string_view::npos ? std::string_view() : names.substr(comma + 1);
+            while (!name.empty() && name.front() == ' ')
+                name.remove_prefix(1);
+            while (!name.empty() && name.back() == ' ')
+                name.remove_suffix(1);
+            if (name == "pid")
+                mask |= kPid;
+            else if (name == "tid")
+                mask |= kTid;
+            else if (name == "thread")
+                mask |= kThread;
+            else if (!name.empty())
+                throw std::invalid_argument("Unknown identity field: " + std::string(name));
+        }
+        return mask;
+    }
+
+    static std::string names(unsigned mask)
+    {
+        std::string out;
+        for (auto [bit, name] : {std::pair<unsigned, const char *>{kPid, "pid"}, {kTid, "tid"}, {kThread, "thread"}})
+        {
+            if (mask & bit)
+                out.append(out.empty() ? "" : ",").append(name);
+        }
+        return out;
+    }
+
+    /**
+     * @brief The rendered fields of `mask` for the calling thread (GIL held)
+     */
+    static std::string_view render(unsigned mask)
+    {
+        thread_local Cache cache;
+        const uint64_t epoch = epoch_.load(std::memory_order_acquire);
+        if (cache.mask != mask || cache.epoch != epoch)
+        {
+            cache.rendered.clear();
+            char buf[32];
+            if (mask & kPid)
+            {
+                snprintf(buf, sizeof(buf), "pid=%lld ", static_cast<long long>(pid()));
+                cache.rendered.append(buf);
+            }
+            if (mask & kTid)
+            {
+                snprintf(buf, sizeof(buf), "tid=%llu ", static_cast<unsigned long long>(tid()));
+                cache.rendered.append(buf);
+            }
+            if (mask & kThread)
+                cache.rendered.append("thread=").append(thread_name()).append(" ");
+            if (!cache.rendered.empty())
+                cache.rendered.append("| ");
+            cache.mask = mask;
+            cache.epoch = epoch;
+        }
+        return cache.rendered;
+    }
+
+    /**
+     * @brief Drop the cached rendering of every thread
+     */
+    static void invalidate() { epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+private:
+    struct Cache
+    {
+        unsigned mask = 0;
+        uint64_t epoch = ~uint64_t(0);
+        std::string rendered;
+    };
+
+    static inline std::atomic<uint64_t> epoch_{0};
+
+    static int64_t pid()
+    {
+#ifdef _WIN32
+        return _getpid();
+#else
+        static const bool registered = []
+        {
+            pthread_atfork(nullptr, nullptr, [] { invalidate(); });
+            return true;
+        }();
+        (void)registered;
+        return ::getpid();
+#endif
+    }
+
+    static uint64_t tid()
+    {
+#if defined(_WIN32)
+        return GetCurrentThreadId();
+#elif defined(__linux__)
+        return static_cast<uint64_t>(::syscall(SYS_gettid));
+#elif defined(__APPLE__)
+        uint64_t id = 0;
+        pthread_threadid_np(nullptr, &id);
+        return id;
+#else
+        return std::hash<std::thread::id>{}(std::this_thread::get_id());
+#endif
+    }
+
+    static std::string thread_name()
+    {
+        return nb::cast<std::string>(current_thread_().attr("name"));
+    }
+
+public:
+    /**
+     * @brief Resolve `threading.current_thread` (called once from the module init, under the GIL)
+     */
+    static void init()
+    {
+        // Leaked: released during static destruction, it would be DECREF'd after the interpreter is gone
+        current_thread_ = nb::object(nb::module_::import_("threading").attr("current_thread")).release();
+    }
+
+private:
+    static inline nb::handle current_thread_;
+};
+
+/**
+ * @brief A log file shared by the configuration snapshots that write to it
+ *
+ * The file is closed when the last snapshot referring to it is reclaimed, so records
+ * formatted against an old snapshot still reach the old file after `reconfigure()` switched
+ * to a new one.
+ */
+class FileSink
+{
+public:
+    FileSink(const std::string &file_path, const std::string &mode)
+    {
+        fs::create_directories(fs::path(file_path).parent_path());
+        stream_.open(file_path, mode == "w" ? std::ios::trunc : std::ios::app);
+        if (!stream_.is_open())
+            std::cerr << "Failed to open file: " << file_path << std::endl;
+    }
+
+    void write(std::string_view record)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stream_.is_open())
+            stream_.write(record.data(), static_cast<std::streamsize>(record.size()));
+    }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stream_.is_open())
+            stream_.flush();
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stream_.is_open())
+            stream_.close();
+    }
+
+private:
+    std::mutex mutex_;
+    std::ofstream stream_;
+};
+
+class CppLogger;
+
+/**
+ * @brief Opt-in runtime control of logger levels from outside the process
+ *
+ * A background thread applies level overrides to every live logger by publishing new
+ * configuration snapshots, so the logging hot path keeps comparing a single integer.
+ * Overrides come from two channels:
+ *  - `SIGUSR2` (POSIX only) toggles all loggers between their own level and `signal_level`.
+ *    With an opt-in `clear_signal` it sets the override instead and that signal lifts it, so
+ *    repeated signals are idempotent. No other signal is touched by default, since schedulers
+ *    and user code often own `SIGUSR1`. The handler only writes a byte naming the action to a
+ *    self-pipe, which wakes the thread; each byte is applied on its own.
+ *  - A control file, checked every `poll_interval` seconds, with one `LEVEL` (all loggers) or
+ *    `name=LEVEL` (loggers with that name) per line; levels are names or numbers, and `#`
+ *    starts a comment. Removing a line (or the file) restores the loggers' own levels.
+ * The signal override takes precedence over the file. Overrides live in their own field of the
+ * logger settings, so the loggers' own levels stay untouched and can still be changed meanwhile.
+ */
+class LevelControl
+{
+public:
+    static void add(CppLogger *logger);
+    static void remove(CppLogger *logger);
+    static void start(bool use_signal, const std::string &control_file, double poll_interval, int signal_level,
+                      int clear_signal);
+    static void stop();
+    static void flush_all();
+    template <typename Fn>
+    static bool try_for_each(Fn &&fn);
+
+private:
+    static void run();
+    static void wait();
+    static void reload_control_file();
+    static void apply(CppLogger *logger);
+    static std::optional<int> parse_level(std::string_view text);
+
+#ifndef _WIN32
+    static constexpr char kToggle = 'T', kSet = 'S', kClear = 'C', kWake = 'W'; // bytes written to the self-pipe
+
+    static void on_signal(int signal)
+    {
+        const int saved_errno = errno;
+        char byte = kWake;
+        if (signal == SIGUSR2)
+            byte = clear_signal_ ? kSet : kToggle;
+        else if (signal != 0 && signal == clear_signal_)
+            byte = kClear;
+        (void)!::write(pipe_[1], &byte, 1);
+        errno = saved_errno;
+    }
+
+    static void restore_signals();
+    static void after_fork_child();
+
+    static inline int pipe_[2] = {-1, -1};
+    static inline volatile sig_atomic_t clear_signal_ = 0; // 0 when `SIGUSR2` toggles
+    static inline struct sigaction previous_usr2_, previous_clear_;
+#endif
+
+    static inline std::mutex mutex_; // guards everything below
+    static inline std::condition_variable wake_;
+    static inline std::thread thread_;
+    static inline bool running_ = false, stopping_ = false, use_signal_ = false, signal_active_ = false;
+    static inline int signal_level_ = 10;
+    static inline double poll_interval_ = 1.0;
+    static inline std::string control_file_;
+    static inline fs::file_time_type control_mtime_{};
+    static inline bool control_exists_ = false;
+    static inline std::optional<int> file_level_;                         // bare `LEVEL` line
+    static inline std::unordered_map<std::string, int> file_levels_;      // `name=LEVEL` lines
+    static inline std::vector<CppLogger *> loggers_;
+};
+
+/**
+ * @brief A C++ logger class that provides core logging functionality for `LightLog`
+ *
+ * This class implements a logging workflow that can output to both console and file.
+ * It supports rank-based logging for distributed systems and various log levels.
+ */
+class CppLogger : public std::streambuf
+{
+public:
+    /**
+     * @brief Construct a new CppLogger object
+     *
+     * @param name The name of the logger
+     * @param file_path Path to the log file (optional)
+     * @param mode File opening mode (default: "a" for append)
+     * @param level Logging level (default: 20 for INFO)
+     * @param use_rank Whether to use rank-based logging (default: false)
+     * @param rank Process rank for distributed logging (default: 0)
+     * @param world_size Total number of processes (default: 1)
+     * @param auto_detect_env Environment for auto-detecting rank and world size (default: "none")
+     */
+    CppLogger(const std::string &name,
+              const std::string &file_path = "",
+              const std::string &mode = "a",
+              int level = 0,
+              bool use_rank = false,
+              int rank = 0,
+              int world_size = 1,
+              const std::string &auto_detect_env = "none",
+              int log_rank = -1)
+    {
+        auto config = std::make_unique<Config>();
+        config->name = name;
+        config->file_path = file_path;
+        config->mode = mode;
+        config->level = level;
+        config->use_rank = use_rank;
+        config->rank = rank;
+        config->world_size = world_size;
+        config->log_rank = log_rank;
+        if (use_rank)
+            std::tie(config->rank, config->world_size) = get_rank_and_world_size(rank, world_size, auto_detect_env);
+        if (!file_path.empty())
+            config->file = std::make_shared<FileSink>(file_path, mode);
+        config->shard = std::hash<std::string>{}(file_path);
+        config->console_color = resolve_color(config->color_mode);
+        config->console_tty = stdout_is_terminal();
+        config->render();
+        config_.store(config.release());
+        LevelControl::add(this);
+    }
+
+    /**
+     * @brief Destroy the CppLogger object
+     *
+     * Ensures all buffered data is flushed and files are closed.
+     */
+    ~CppLogger()
+    {
+        LevelControl::remove(this); // also stops drop reports for this logger
+        flush();                    // writes the records still queued for this logger
+        close();
+        const Config *config = config_.exchange(nullptr);
+        EpochDomain::instance().retire([config] { release_config(config); });
+    }
+
+    /**
+     * @brief Flush the logger, writing any buffered data
+     */
+    void flush()
+    {
+        drain_async_writer();
+        {
+            std::lock_guard<std::mutex> lock(metrics_mutex_);
+            if (metrics_file_.is_open())
+                metrics_file_.flush();
+        }
+        EpochGuard guard;
+        const Config *config = this->config();
+        if (config->file)
+            config->file->flush();
+        for (const Route &route : config->routes)
+            route.file->flush();
+        std::lock_guard<std::mutex> lock(console_mutex_);
+        std::cout.flush();
+    }
+
+    /**
+     * @brief Close the log file if it's open
+     */
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(metrics_mutex_);
+            if (metrics_file_.is_open())
+            {
+                if (pending_scalars_)
+                    log_scalar_summary(); // may be queued: drained below, before the sinks close
+                metrics_file_.close();
+                metrics_names_.close();
+            }
+        }
+        drain_async_writer();
+        EpochGuard guard;
+        const Config *config = this->config();
+        if (config->file)
+            config->file->close();
+        for (const Route &route : config->routes)
+            route.file->close();
+    }
+
+    /**
+     * @brief Log a message with specified level and options
+     *
+     * @param msg The message to log
+     * @param level The log level for this message
+     * @param use_rank Whether to include rank information for this message
+     * @param new_file Optional new file to log this message to
+     */
+    void log(const std::string &msg, int level, bool use_rank = false, const std::string &new_file = "")
+    {
+        log_with(msg, level, use_rank, new_file, false);
+    }
+
+    /**
+     * @brief Log text made of several lines with the full prefix on every line
+     *
+     * Used by the `write()` path, which hands over all complete lines of its buffer in one call.
+     */
+    void log_lines(const std::string &msg, int level, bool use_rank = false, const std::string &new_file = "")
+    {
+        log_with(msg, level, use_rank, new_file, true);
+    }
+
+    /**
+     * @brief How the physical lines of a message after the first are prefixed: "first", "prefix" or "indent"
+     */
+    [[nodiscard]] std::string multiline() const
+    {
+        EpochGuard guard;
+        const Multiline multiline = config()->multiline;
+        return multiline == Multiline::kPrefix ? "prefix" : multiline == Multiline::kIndent ? "indent" : "first";
+    }
+    void set_multiline(const std::string &mode)
+    {
+        Multiline multiline;
+        if (mode == "first")
+            multiline = Multiline::kFirst;
+        else if (mode == "prefix")
+            multiline = Multiline::kPrefix;
+        else if (mode == "indent")
+            multiline = Multiline::kIndent;
+        else
+            throw std::invalid_argument("Unknown multiline mode: " + mode + " (expected 'first', 'prefix' or 'indent')");
+        update_config([&](Config &config) { config.multiline = multiline; });
+    }
+
+private:
+    enum class Multiline
+    {
+        kFirst,  // prefix on the first line only
+        kPrefix, // full prefix on every line
+        kIndent, // continuation lines are indented under the message column
+    };
+
+    /**
+     * @brief A sink that receives the records whose level lies in [min_level, max_level]
+     */
+    struct Route
+    {
+        std::string target; // "console" or an absolute file path
+        int min_level = INT_MIN, max_level = INT_MAX;
+        std::shared_ptr<FileSink> file; // null for the console
+
+        [[nodiscard]] bool accepts(int level) const { return level >= min_level && level <= max_level; }
+    };
+
+    /**
+     * @brief Settings read by the logging hot path, published as an immutable snapshot
+     *
+     * Writers copy the current snapshot, change the copy and publish it through `config_`, so
+     * a concurrent `log()` sees either the old or the new settings, never a mix of both.
+     * Replaced snapshots are reclaimed through the `EpochDomain` once no reader can hold them.
+     */
+    struct Config
+    {
+        std::string name, file_path, mode, auto_detect_env;
+        int level = 0, rank = 0, world_size = 1, log_rank = -1;
+        int level_override = -1; // set by `LevelControl`; while >= 0 it is used instead of `level`
+        bool use_rank = false;
+        bool capture_location = false;
+        unsigned identity_fields = 0; // ThreadIdentity::Field mask
+        Multiline multiline = Multiline::kFirst;
+        std::shared_ptr<FileSink> file; // shared with the snapshots that did not change the file
+        Route console{"console", INT_MIN, INT_MAX, nullptr}; // level range printed to stdout
+        std::vector<Route> routes;      // additional files, each with its own level range
+        std::string color_mode = "auto";
+        bool console_color = false;     // resolved from `color_mode` when it is set, not per record
+        bool console_tty = false;       // stdout was a terminal when the logger was created
+        int64_t latency_budget_ns = 0;  // > 0: records go through the writer pool, see `dispatch()`
+        int priority_level = 0;         // > 0: queued records at or above it take the priority lane
+        size_t shard = 0;               // writer shard of queued records, shared per `file_path`
+        std::string rank_label;         // "[rank/world_size] ", rendered by `render()`
+
+        /**
+         * @brief One reference for the publication plus one per record queued with the snapshot
+         *
+         * Not copied with the settings: every snapshot starts with the publication's reference.
+         */
+        struct References
+        {
+            mutable std::atomic<size_t> count{1};
+            References() = default;
+            References(const References &) {}
+            References &operator=(const References &) { return *this; }
+        } references;
+
+        [[nodiscard]] bool enabled(int msg_level) const
+        {
+            return msg_level >= (level_override >= 0 ? level_override : level) &&
+                   (log_rank == -1 || rank == log_rank); // only log on specific rank
+        }
+
+        void render() { rank_label = "[" + std::to_string(rank) + "/" + std::to_string(world_size) + "] "; }
+    };
+
+    /**
+     * @brief Drop a reference to `config`, deleting it with the last one
+     *
+     * The publication's reference is dropped by the `EpochDomain` once no reader can see the
+     * snapshot, the others by the writer threads after writing a record queued with it.
+     */
+    static void release_config(const Config *config)
+    {
+        if (config->references.count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete config;
+    }
+
+    /**
+     * @brief The current settings; only valid while the caller holds an `EpochGuard`
+     */
+    [[nodiscard]] const Config *config() const { return config_.load(); }
+
+    /**
+     * @brief Whether a message at `level` passes the level and rank filters
+     */
+    [[nodiscard]] bool enabled(int level) const
+    {
+        EpochGuard guard;
+        return config()->enabled(level);
+    }
+
+    /**
+     * @brief Apply `change` to a copy of the settings, publish it and retire the old snapshot
+     *
+     * Writers are serialized; readers are never blocked.
+     */
+    template <typename Change>
+    void update_config(Change &&change)
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        auto next = std::make_unique<Config>(*config_.load());
+        change(*next);
+        next->render();
+        const Config *old = config_.exchange(next.release());
+        EpochDomain::instance().retire([old] { release_config(old); });
+    }
+
+    void log_with(const std::string &msg, int level, bool use_rank, const std::string &new_file, bool prefix_every_line)
+    {
+        EpochGuard guard;
+        const Config *config = this->config();
+        if (!config->enabled(level))
+            return;
+
+        nb::object context = level != 0 ? LogContext::current() : nb::none();
+        const LogContext *frame = LogContext::from(context);
+        std::string location;
+        if (config->capture_location && level != 0)
+            CallerLocation::render(location);
+        std::string_view identity = config->identity_fields && level != 0 ? ThreadIdentity::render(config->identity_fields) : std::string_view();
+        if (level != 0)
+            identity = stamp_sequence(*config, identity);
+
+        // Format into this thread's staging buffer, which keeps its capacity between calls; it is
+        // allocated and first written by this thread, so its pages sit on this thread's NUMA node
+        thread_local std::string staging;
+        format_message(staging, *config, msg, level, (use_rank || config->use_rank) ? std::string_view(config->rank_label) : std::string_view(),
+                       location, identity, frame ? std::string_view(frame->rendered()) : std::string_view(),
+                       prefix_every_line ? Multiline::kPrefix : config->multiline);
+        dispatch(*config, staging, level, new_file);
+    }
+
+    /**
+     * @brief `identity` followed by a "seq=N | " stamp while the logger uses a priority lane
+     *
+     * The priority lane reorders records, so every line with a header is stamped for sorting
+     * the file offline: records, progress lines and drop reports alike. The result is valid
+     * until the calling thread's next call.
+     */
+    static std::string_view stamp_sequence(const Config &config, std::string_view identity)
+    {
+        if (config.priority_level <= 0 || config.latency_budget_ns <= 0)
+            return identity;
+        thread_local std::string stamped;
+        stamped.assign(identity).append("seq=").append(std::to_string(next_sequence_.fetch_add(1, std::memory_order_relaxed))).append(" | ");
+        return stamped;
+    }
+
+    /**
+     * @brief Write a formatted record now, or hand it to the writer threads if the logger has a latency budget
+     *
+     * A record that cannot be queued within the budget is dropped and counted instead. Records
+     * at or above `priority_level` take the lane the writers empty first. Records are sharded
+     * by the logger's own file, so a logger's records, and those of loggers sharing that file,
+     * stay in logging order. Other sinks are not part of the key: a route file or the console
+     * shared by loggers with different files may receive their records interleaved out of
+     * order, and `new_file` records are only ordered with the logger's file. A queued record
+     * holds a reference to `config`, so the writer uses the sinks it was routed with even after
+     * a reconfiguration. `console` false leaves out the console, as in `write_record`.
+     */
+    void dispatch(const Config &config, std::string_view record, int level, const std::string &new_file,
+                  bool console = true)
+    {
+        if (config.latency_budget_ns <= 0)
+        {
+            write_record(config, record, level, new_file, console);
+            return;
+        }
+        const auto lane = config.priority_level > 0 && level >= config.priority_level ? AsyncWriter::kPriority : AsyncWriter::kNormal;
+        config.references.count.fetch_add(1, std::memory_order_relaxed); // safe: the caller's guard keeps it alive
+        if (!async_writer().try_push(config.shard, lane, this, &config, level, record, new_file,
+                                     std::chrono::nanoseconds(config.latency_budget_ns), console))
+        {
+            release_config(&config);
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            dropped_unreported_.fetch_add(1, std::memory_order_relaxed);
+            drops_pending_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Hand one formatted record to every sink of `config` whose level range accepts it
+     *
+     * The record is formatted once by the caller; each sink receives the same buffer in a single write.
+     */
+    void write_record(const Config &config, std::string_view record, int level, const std::string &new_file,
+                      bool console = true)
+    {
+        if (console && config.console.accepts(level))
+        {
+            std::string_view color;
+            if (config.console_color && level > 0 && level < LevelRegistry::kSize)
+                color = LevelRegistry::table().levels[static_cast<size_t>(level)].color;
+            std::lock_guard<std::mutex> lock(console_mutex_);
+            if (!bar_.text.empty())
+                std::cout.write("\r\033[K", 4); // the record takes the place of the progress line
+            if (color.empty())
+                std::cout.write(record.data(), static_cast<std::streamsize>(record.size()));
+            else
+                write_colored(color, record);
+            if (!bar_.text.empty())
+                std::cout.write(bar_.text.data(), static_cast<std::streamsize>(bar_.text.size()));
+        }
+
+        if (!new_file.empty())
+            log_to_file(record, new_file);
+        else if (config.file)
+            config.file->write(record);
+        for (const Route &route : config.routes)
+        {
+            if (route.accepts(level))
+                route.file->write(record);
+        }
+    }
+
+    /**
+     * @brief Write `record` to stdout wrapped in `color` and a reset, keeping a trailing newline outside
+     *
+     * Resetting before the newline stops the color from bleeding into the next line of the terminal.
+     */
+    static void write_colored(std::string_view color, std::string_view record)
+    {
+        static constexpr std::string_view reset = "\033[0m";
+        const bool newline = !record.empty() && record.back() == '\n';
+        if (newline)
+            record.remove_suffix(1);
+        std::cout.write(color.data(), static_cast<std::streamsize>(color.size()));
+        std::cout.write(record.data(), static_cast<std::streamsize>(record.size()));
+        std::cout.write(reset.data(), static_cast<std::streamsize>(reset.size()));
+        if (newline)
+            std::cout.put('\n');
+    }
+
+    /**
+     * @brief Whether console records get ANSI colors for `mode` ("auto", "always" or "never")
+     *
+     * "auto" colors only when stdout is a terminal and `NO_COLOR` is not set.
+     */
+    static bool resolve_color(const std::string &mode)
+    {
+        if (mode == "always")
+            return true;
+        if (mode == "never")
+            return false;
+        if (mode != "auto")
+            throw std::invalid_argument("Unknown color mode: " + mode + " (expected 'auto', 'always' or 'never')");
+        if (const char *no_color = std::getenv("NO_COLOR"); no_color && *no_color)
+            return false;
+        return stdout_is_terminal();
+    }
+
+    /**
+     * @brief Whether stdout is a terminal that understands ANSI escape sequences
+     *
+     * On Windows this also enables escape sequence processing of the console.
+     */
+    static bool stdout_is_terminal()
+    {
+#ifdef _WIN32
+        if (!_isatty(_fileno(stdout)))
+            return false;
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD console_mode = 0;
+        return GetConsoleMode(console, &console_mode) &&
+               SetConsoleMode(console, console_mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#else
+        return ::isatty(STDOUT_FILENO) == 1;
+#endif
+    }
+
+public:
+    /**
+     * @brief Join `print()`-style arguments and log them (backs `log`, `info`, ... in Python)
+     *
+     * The level is checked before any argument is converted, so filtered calls cost only the
+     * argument parsing. `str` arguments are copied as UTF-8 without creating new objects.
+     *
+     * @param args The message components; non-`str` objects are converted with `str()`
+     * @param sep Separator between the components (None means " ")
+     * @param end String appended after the message (None means "\n")
+     * @param level The log level for this message
+     * @param use_rank Whether to include rank information for this message
+     * @param new_file_path Optional new file to log this message to (None or "" for none)
+     */
+    void log_args(nb::args args, nb::handle sep, nb::handle end, int level, bool use_rank, nb::handle new_file_path)
+    {
+        if (!enabled(level))
+            return;
+
+        std::string msg;
+        const std::string_view sep_view = sep.is_none() ? std::string_view(" ") : utf8(sep);
+        const size_t n = nb::len(args);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (i)
+                msg.append(sep_view);
+            nb::handle arg = args[i];
+            if (PyUnicode_Check(arg.ptr()))
+                msg.append(utf8(arg));
+            else
+            {
+                nb::str text(arg);
+                msg.append(utf8(text));
+            }
+        }
+        msg.append(end.is_none() ? std::string_view("\n") : utf8(end));
+
+        std::string new_file;
+        if (!new_file_path.is_none())
+        {
+            std::string_view path = utf8(new_file_path);
+            if (!path.empty())
+                new_file = fs::absolute(fs::path(std::string(path))).lexically_normal().string();
+        }
+        log(msg, level, use_rank, new_file);
+    }
+
+    /**
+     * @brief Log a message followed by an exception and its traceback as a single record
+     *
+     * The whole block is formatted into one buffer and handed to each sink in one write,
+     * so it cannot interleave with lines from other threads.
+     *
+     * @param msg The message to log
+     * @param level The log level for this message (default: 40 for ERROR)
+     * @param exc The exception to render (default: None, the exception currently being handled)
+     * @param use_rank Whether to include rank information for this message
+     * @param new_file Optional new file to log this message to
+     */
+    void log_exception(const std::string &msg, int level = 40, nb::handle exc = nb::handle(), bool use_rank = false,
+                       const std::string &new_file = "")
+    {
+        if (!enabled(level))
+            return;
+        nb::object error = (!exc.is_valid() || exc.is_none()) ? ExceptionFormatter::current() : nb::borrow<nb::object>(exc);
+        if (error.is_none())
+        {
+            log(msg, level, use_rank, new_file);
+            return;
+        }
+        std::string block = msg;
+        if (!block.empty() && block.back() != '\n')
+            block += '\n';
+        ExceptionFormatter::render(error, block);
+        log(block, level, use_rank, new_file);
+    }
+
+    /**
+     * @brief The logger's name and current level threshold
+     */
+    [[nodiscard]] std::string name() const
+    {
+        EpochGuard guard;
+        return config()->name;
+    }
+    [[nodiscard]] int level() const
+    {
+        EpochGuard guard;
+        return config()->level;
+    }
+    void set_level(int level)
+    {
+        update_config([&](Config &config) { config.level = level; });
+    }
+
+    /**
+     * @brief Level imposed by `LevelControl` regardless of the logger's own level (-1 for none)
+     *
+     * Kept apart from `level`, so `set_level` and `reconfigure` during an override change the
+     * level the logger returns to once the override is lifted.
+     */
+    [[nodiscard]] int level_override() const
+    {
+        EpochGuard guard;
+        return config()->level_override;
+    }
+    void set_level_override(int level)
+    {
+        if (level_override() != level)
+            update_config([&](Config &config) { config.level_override = level; });
+    }
+
+    /**
+     * @brief Whether formatted lines include the caller's `file:line:function`
+     */
+    [[nodiscard]] bool capture_location() const
+    {
+        EpochGuard guard;
+        return config()->capture_location;
+    }
+    void set_capture_location(bool enabled)
+    {
+        update_config([&](Config &config) { config.capture_location = enabled; });
+    }
+
+    /**
+     * @brief Comma-separated identity fields (`pid`, `tid`, `thread`) added to formatted lines
+     */
+    [[nodiscard]] std::string identity_fields() const
+    {
+        EpochGuard guard;
+        return ThreadIdentity::names(config()->identity_fields);
+    }
+    void set_identity_fields(const std::string &fields)
+    {
+        const unsigned mask = ThreadIdentity::parse(fields);
+        update_config([&](Config &config) { config.identity_fields = mask; });
+    }
+
+    /**
+     * @brief Console coloring by level: "auto" (only on a terminal), "always" or "never"
+     *
+     * The terminal check runs once when the mode is set, never per record.
+     */
+    [[nodiscard]] std::string color() const
+    {
+        EpochGuard guard;
+        return config()->color_mode;
+    }
+    void set_color(const std::string &mode)
+    {
+        const bool enabled = resolve_color(mode);
+        update_config([&](Config &config)
+                      {
+            config.color_mode = mode;
+            config.console_color = enabled; });
+    }
+
+    /**
+     * @brief Longest time in microseconds a logging call may wait to hand its record to the writer thread
+     *
+     * 0 (the default) writes records synchronously in the calling thread.
+     */
+    [[nodiscard]] double latency_budget() const
+    {
+        EpochGuard guard;
+        return static_cast<double>(config()->latency_budget_ns) / 1000.0;
+    }
+    void set_latency_budget(double microseconds)
+    {
+        if (!(microseconds >= 0))
+            throw std::invalid_argument("latency_budget must be >= 0 microseconds");
+        update_config([&](Config &config) { config.latency_budget_ns = static_cast<int64_t>(microseconds * 1000.0); });
+    }
+
+    /**
+     * @brief Lowest level of queued records that take the priority lane (0 disables the lane)
+     */
+    [[nodiscard]] int priority_level() const
+    {
+        EpochGuard guard;
+        return config()->priority_level;
+    }
+    void set_priority_level(int level)
+    {
+        update_config([&](Config &config) { config.priority_level = std::max(level, 0); });
+    }
+
+    /**
+     * @brief Records dropped because they could not be queued within the latency budget
+     */
+    [[nodiscard]] uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set up the writer pool and the other background threads, and how often drops are reported
+     *
+     * Everything but the report interval applies to threads that have not started yet, so it
+     * must be set before the first logger with a latency budget logs.
+     *
+     * @param cpu_affinity CPUs the background threads may run on (empty for any)
+     * @param nice Nice value of the background threads
+     * @param idle_priority Schedule the background threads only on otherwise idle CPUs
+     * @param spin_us Microseconds a writer thread keeps polling for records before it parks
+     * @param huge_pages Backing of the queue rings: "off", "transparent" or "explicit"
+     */
+    static void configure_engine(size_t queue_capacity, size_t priority_capacity, double drop_report_interval,
+                                 size_t writer_threads, const std::vector<int> &cpu_affinity, int nice,
+                                 bool idle_priority, double spin_us, const std::string &huge_pages)
+    {
+        const HugePages pages = RingMemory::parse(huge_pages);
+        if (queue_capacity == 0 || priority_capacity == 0)
+            throw std::invalid_argument("queue capacities must be positive");
+        if (writer_threads == 0)
+            throw std::invalid_argument("writer_threads must be positive");
+        if (!(spin_us >= 0.0))
+            throw std::invalid_argument("spin_us must not be negative");
+        if (!(drop_report_interval >= 0.0))
+            throw std::invalid_argument("drop_report_interval must not be negative");
+        ThreadPolicy policy{cpu_affinity, nice, idle_priority};
+        policy.validate();
+        const auto spin = std::chrono::nanoseconds(static_cast<int64_t>(std::min(spin_us, 1e9) * 1000.0));
+
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        if (async_writer_.load() && (queue_capacity != async_capacity_ || priority_capacity != async_priority_capacity_ ||
+                                     writer_threads != async_threads_ || spin != async_spin_ ||
+                                     pages != async_huge_pages_ || policy != ThreadPolicy::current()))
+            throw std::runtime_error("the writer threads are already running; configure the engine before the first "
+                                     "logger with a latency budget logs");
+        async_capacity_ = queue_capacity;
+        async_priority_capacity_ = priority_capacity;
+        async_threads_ = writer_threads;
+        async_spin_ = spin;
+        async_huge_pages_ = pages;
+        ThreadPolicy::set(std::move(policy));
+        drop_report_interval_.store(drop_report_interval);
+    }
+
+    using SinkSpec = std::tuple<std::string, int, int>; // (target, min_level, max_level)
+
+    /**
+     * @brief Level-routed sinks as `(target, min_level, max_level)`, the console first
+     */
+    [[nodiscard]] std::vector<SinkSpec> sinks() const
+    {
+        EpochGuard guard;
+        const Config *config = this->config();
+        std::vector<SinkSpec> result{{"console", config->console.min_level, config->console.max_level}};
+        for (const Route &route : config->routes)
+            result.emplace_back(route.target, route.min_level, route.max_level);
+        return result;
+    }
+
+    /**
+     * @brief Replace the level-routed sinks
+     *
+     * `target` is "console" (stdout, which receives every level if it is not listed) or the
+     * absolute path of an additional file. Files that stay routed keep their open stream.
+     *
+     * @throws std::invalid_argument for a repeated target, `min_level > max_level` or the logger's own file
+     */
+    void set_sinks(const std::vector<SinkSpec> &sinks)
+    {
+        std::unordered_set<std::string> targets;
+        for (const auto &[target, min_level, max_level] : sinks)
+        {
+            if (min_level > max_level)
+                throw std::invalid_argument("sink '" + target + "' has min_level " + std::to_string(min_level) +
+                                            " above max_level " + std::to_string(max_level));
+            if (!targets.insert(target).second)
+                throw std::invalid_argument("sink '" + target + "' is listed more than once");
+        }
+        update_config([&](Config &config)
+                      {
+            Route console{"console", INT_MIN, INT_MAX, nullptr};
+            std::vector<Route> routes;
+            for (const auto &[target, min_level, max_level] : sinks)
+            {
+                Route route{target, min_level, max_level, nullptr};
+                if (target == "console")
+                {
+                    console = route;
+                    continue;
+                }
+                if (target == config.file_path)
+                    throw std::invalid_argument("'" + target + "' is already the logger's file; set the logger level instead");
+                for (const Route &existing : config.routes)
+                {
+                    if (existing.target == target)
+                        route.file = existing.file;
+                }
+                if (!route.file)
+                    route.file = std::make_shared<FileSink>(target, config.mode);
+                routes.push_back(std::move(route));
+            }
+            config.console = std::move(console);
+            config.routes = std::move(routes); });
+    }
+
+    /**
+     * @brief Open the binary series file used by `log_scalar`
+     *
+     * @throws std::runtime_error when appending to a non-empty file whose header does not match
+     *
+     * @param path Path of the series file (default: the log file path plus ".metrics", or "<name>.metrics")
+     * @param summary_interval Seconds between summary lines written to the normal sinks (0 disables them)
+     */
+    void open_metrics(const std::string &path = "", double summary_interval = 60.0)
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        open_metrics_locked(path, summary_interval);
+    }
+
+    /**
+     * @brief Append one scalar sample to the binary series file
+     *
+     * Costs a hash lookup and a 32-byte buffered write; a summary line is only formatted
+     * once every `summary_interval` seconds.
+     *
+     * @param name Name of the series
+     * @param value The sample value
+     * @param step Training step or any other monotonically increasing counter
+     */
+    void log_scalar(const std::string &name, double value, int64_t step)
+    {
+        {
+            EpochGuard guard;
+            if (const Config *config = this->config(); config->log_rank != -1 && config->rank != config->log_rank)
+                return; // only log on specific rank
+        }
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        if (!metrics_file_.is_open())
+        {
+            open_metrics_locked(metrics_path_, summary_interval_);
+            if (!metrics_file_.is_open())
+                return;
+        }
+
+        auto it = scalars_.find(name);
+        if (it == scalars_.end())
+        {
+            it = scalars_.emplace(name, ScalarState{static_cast<uint32_t>(scalar_names_.size())}).first;
+            scalar_names_.push_back(name);
+            metrics_names_ << name << '\n';
+            metrics_names_.flush(); // readers must never see an id without its name
+        }
+        ScalarState &state = it->second;
+
+        const auto now = std::chrono::system_clock::now();
+        MetricRecord record{state.id, 0, step, value,
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count()};
+        metrics_file_.write(reinterpret_cast<const char *>(&record), sizeof(record));
+
+        state.last = value;
+        state.step = step;
+        state.sum += value;
+        ++state.count;
+        ++pending_scalars_;
+
+        if (summary_interval_ > 0 &&
+            std::chrono::steady_clock::now() - last_summary_ >= std::chrono::duration<double>(summary_interval_))
+            log_scalar_summary();
+    }
+
+    /**
+     * @brief Log a Python warning at WARNING level, at most once per (category, filename, lineno) if `dedup`
+     *
+     * @return Whether a line was written
+     */
+    bool log_warning(const std::string &message, const std::string &category, const std::string &filename,
+                     int lineno, bool dedup)
+    {
+        if (!enabled(30))
+            return false;
+        std::string location = filename + ":" + std::to_string(lineno);
+        if (dedup)
+        {
+            std::string key = category;
+            key.append(1, '\0').append(location);
+            std::lock_guard<std::mutex> lock(warnings_mutex_);
+            if (!warnings_seen_.insert(std::move(key)).second)
+                return false;
+        }
+        log(location + ": " + category + ": " + message + "\n", 30);
+        return true;
+    }
+
+    /**
+     * @brief Report the progress of a long-running loop under `key`
+     *
+     * On a terminal the console line is rewritten in place with `\r` at most every 100 ms.
+     * Files (and a console that is not a terminal) get a line on the first call, every
+     * `interval` seconds or `step` percent, and when `current` reaches `total`. Calls that
+     * emit nothing still take a mutex and look up `key`, but format nothing. Console records
+     * written while a bar is shown replace its line and the bar is redrawn below them.
+     * Keys unused for an hour, and the least recently used beyond 1024, are forgotten. Under a
+     * latency budget the lines are queued like any record; only the in-place redraw is written
+     * by the caller.
+     *
+     * @param key Name of the progress bar, also its label
+     * @param current Units done so far
+     * @param total Units in total (0 if unknown)
+     * @param extra Text appended to the line, e.g. the current loss
+     * @param level The log level of the lines
+     * @param interval Seconds between lines written to files
+     * @param step Percentage points between lines written to files (0 disables it)
+     */
+    void progress(const std::string &key, double current, double total, const std::string &extra, int level,
+                  double interval, double step)
+    {
+        EpochGuard guard;
+        const Config *config = this->config();
+        if (!config->enabled(level))
+            return;
+
+        const auto now = std::chrono::steady_clock::now();
+        const bool done = total > 0 && current >= total;
+        const bool terminal = config->console_tty && config->console.accepts(level);
+        bool to_file, to_terminal;
+        double elapsed, rate;
+        {
+            std::lock_guard<std::mutex> lock(progress_mutex_);
+            auto [it, fresh] = progress_.try_emplace(key);
+            ProgressState &state = it->second;
+            if (fresh)
+            {
+                state.start = now;
+                state.start_value = current;
+                evict_progress(now, key);
+            }
+            state.last_update = now;
+            const double fraction = total > 0 ? current / total : 0.0;
+            to_terminal = terminal && (fresh || done || now - state.last_terminal >= std::chrono::milliseconds(100));
+            to_file = fresh || done || now - state.last_file >= std::chrono::duration<double>(interval) ||
+                      (step > 0 && total > 0 && (fraction - state.last_fraction) * 100.0 >= step);
+            if (to_terminal)
+                state.last_terminal = now;
+            if (to_file)
+            {
+                state.last_file = now;
+                state.last_fraction = fraction;
+            }
+            elapsed = std::chrono::duration<double>(now - state.start).count();
+            rate = elapsed > 0 ? (current - state.start_value) / elapsed : 0.0;
+            if (done)
+                progress_.erase(it);
+        }
+        if (!to_file && !to_terminal)
+            return;
+
+        std::string msg;
+        render_progress(msg, key, current, total, elapsed, rate, extra);
+        nb::object context = LogContext::current();
+        const LogContext *frame = LogContext::from(context);
+        thread_local std::string staging;
+        format_message(staging, *config, msg, level, config->use_rank ? std::string_view(config->rank_label) : std::string_view(),
+                       {}, stamp_sequence(*config, {}), frame ? std::string_view(frame->rendered()) : std::string_view(), Multiline::kFirst);
+
+        if (to_terminal)
+        {
+            // Carriage return, the line, then erase whatever a longer previous line left behind
+            std::string_view color;
+            if (config->console_color && level > 0 && level < LevelRegistry::kSize)
+                color = LevelRegistry::table().levels[static_cast<size_t>(level)].color;
+            std::lock_guard<std::mutex> lock(console_mutex_);
+            std::string &bar = bar_.text;
+            bar.assign(1, '\r').append(color).append(staging).append(color.empty() ? "\033[K" : "\033[0m\033[K");
+            std::cout.write(bar.data(), static_cast<std::streamsize>(bar.size()));
+            if (done)
+            {
+                std::cout.put('\n'); // the finished line stays, and no bar is shown anymore
+                bar_ = TerminalBar{};
+            }
+            else
+            {
+                bar_.owner = this;
+                bar_.key = key;
+            }
+            std::cout.flush();
+        }
+        if (to_file)
+        {
+            // Queued under a latency budget; only the in-place redraw above is synchronous
+            staging.push_back('\n');
+            dispatch(*config, staging, level, "", !terminal);
+        }
+    }
+
+private:
+    /**
+     * @brief The writer pool, started on first use and never destroyed
+     *
+     * A single thread drains a single shard. A pool gets two shards per thread, so a thread
+     * stuck on a slow file leaves its second shard to be stolen by the others.
+     */
+    static AsyncWriter &async_writer()
+    {
+        if (AsyncWriter *writer = async_writer_.load(std::memory_order_acquire))
+            return *writer;
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        if (!async_writer_.load())
+        {
+#ifndef _WIN32
+            // The threads do not exist in a forked child: abandon them there and start new ones on demand
+            static const bool registered = []
+            {
+                pthread_atfork(nullptr, nullptr, [] { async_writer_.store(nullptr); });
+                return true;
+            }();
+            (void)registered;
+#endif
+            const size_t shards = async_threads_ == 1 ? 1 : 2 * async_threads_;
+            async_writer_.store(new AsyncWriter(async_threads_, shards, async_capacity_, async_priority_capacity_,
+                                                &write_async, &report_drops,
+                                                [] { ThreadPolicy::apply_current("writer"); }, async_spin_,
+                                                async_huge_pages_));
+        }
+        return *async_writer_.load();
+    }
+
+    /**
+     * @brief Wait until the writer threads wrote every queued record (no-op without a writer)
+     */
+    static void drain_async_writer()
+    {
+        if (AsyncWriter *writer = async_writer_.load(); writer && !AsyncWriter::on_writer_thread())
+            writer->drain();
+    }
+
+    static void write_async(AsyncWriter::Record &record, AsyncWriter::Lane lane)
+    {
+        auto *logger = static_cast<CppLogger *>(record.owner);
+        const auto *config = static_cast<const Config *>(record.settings); // referenced by `dispatch`
+        EpochGuard guard; // for the level colors of the console
+        logger->write_record(*config, record.text, record.level, record.new_file, record.console);
+        if (lane == AsyncWriter::kPriority)
+        {
+            // Priority records must survive the process being killed right after them
+            if (config->file)
+                config->file->flush();
+            for (const Route &route : config->routes)
+                route.file->flush();
+            std::lock_guard<std::mutex> lock(console_mutex_);
+            std::cout.flush();
+        }
+        release_config(config);
+    }
+
+    /**
+     * @brief Idle hook of the writer threads: write "N records dropped" for loggers that lost records
+     */
+    static AsyncWriter::Clock::time_point report_drops()
+    {
+        using Clock = AsyncWriter::Clock;
+        static std::mutex mutex; // one idle thread reports, the others skip
+        static Clock::time_point last; // guarded by `mutex`
+        std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+        if (!lock.owns_lock() || !drops_pending_.load(std::memory_order_relaxed))
+            return Clock::time_point::max(); // the thread holding `mutex` keeps the deadline
+        const auto now = Clock::now();
+        const auto next = last + std::chrono::duration_cast<Clock::duration>(
+                                     std::chrono::duration<double>(std::min(drop_report_interval_.load(), 1e9)));
+        if (now < next)
+            return next;
+        // Cleared first, so a drop during the reports is left for the next round
+        drops_pending_.store(false, std::memory_order_relaxed);
+        if (!LevelControl::try_for_each([](CppLogger *logger) { logger->report_dropped(); }))
+        {
+            drops_pending_.store(true, std::memory_order_relaxed);
+            return now + std::chrono::milliseconds(10); // the logger list is busy: retry shortly
+        }
+        last = now;
+        return Clock::time_point::max();
+    }
+
+    void report_dropped()
+    {
+        if (dropped_unreported_.load(std::memory_order_relaxed) == 0)
+            return;
+        const uint64_t count = dropped_unreported_.exchange(0);
+        EpochGuard guard;
+        const Config *config = this->config();
+        std::string record;
+        format_message(record, *config, std::to_string(count) + " records dropped: the latency budget was exceeded\n", 30,
+                       config->use_rank ? std::string_view(config->rank_label) : std::string_view(), {},
+                       stamp_sequence(*config, {}), {}, Multiline::kFirst);
+        write_record(*config, record, 30, "");
+    }
+
+    struct ProgressState
+    {
+        std::chrono::steady_clock::time_point start, last_file, last_terminal, last_update;
+        double start_value = 0.0;
+        double last_fraction = 0.0; // fraction done at the last line written to files
+    };
+
+    /**
+     * @brief Forget progress keys unused for an hour and, beyond 1024 keys, the least recently used
+     *
+     * Called with `progress_mutex_` held when `keep` is added, so loops that never reach their
+     * total or use a new key per run do not grow the map forever. A forgotten key that is still
+     * shown as the terminal bar is erased from the screen.
+     */
+    void evict_progress(std::chrono::steady_clock::time_point now, const std::string &keep)
+    {
+        static constexpr size_t kMaxKeys = 1024;
+        static constexpr auto kStale = std::chrono::hours(1);
+        auto forget = [this](std::unordered_map<std::string, ProgressState>::iterator it)
+        {
+            {
+                std::lock_guard<std::mutex> lock(console_mutex_);
+                if (bar_.owner == this && bar_.key == it->first)
+                {
+                    std::cout.write("\r\033[K", 4);
+                    std::cout.flush();
+                    bar_ = TerminalBar{};
+                }
+            }
+            return progress_.erase(it);
+        };
+        for (auto it = progress_.begin(); it != progress_.end();)
+            it = it->first != keep && now - it->second.last_update >= kStale ? forget(it) : std::next(it);
+        while (progress_.size() > kMaxKeys)
+        {
+            auto oldest = progress_.end();
+            for (auto it = progress_.begin(); it != progress_.end(); ++it)
+            {
+                if (it->first != keep && (oldest == progress_.end() || it->second.last_update < oldest->second.last_update))
+                    oldest = it;
+            }
+            forget(oldest);
+        }
+    }
+
+    /**
+     * @brief Render "key: 45% 450/1000 [00:12<00:15, 37.5 it/s] extra"
+     */
+    static void render_progress(std::string &out, const std::string &key, double current, double total,
+                                double elapsed, double rate, const std::string &extra)
+    {
+        auto clock = [](double seconds)
+        {
+            char buf[32];
+            const long long s = std::isfinite(seconds) && seconds > 0 ? static_cast<long long>(seconds + 0.5) : 0;
+            if (s >= 3600)
+                snprintf(buf, sizeof(buf), "%lld:%02lld:%02lld", s / 3600, s / 60 % 60, s % 60);
+            else
+                snprintf(buf, sizeof(buf), "%02lld:%02lld", s / 60, s % 60);
+            return std::string(buf);
+        };
+        char buf[96];
+        out.append(key).append(": ");
+        if (total > 0)
+        {
+            snprintf(buf, sizeof(buf), "%3.0f%% %.10g/%.10g [", std::min(current / total, 1.0) * 100.0, current, total);
+            out.append(buf).append(clock(elapsed)).append("<").append(rate > 0 ? clock((total - current) / rate) : "?");
+        }
+        else
+        {
+            snprintf(buf, sizeof(buf), "%.10g [", current);
+            out.append(buf).append(clock(elapsed));
+        }
+        snprintf(buf, sizeof(buf), ", %.3g it/s]", rate);
+        out.append(buf);
+        if (!extra.empty())
+            out.append(" ").append(extra);
     }
 
     /**
-     * @brief Close the log file if it's open
+     * @brief `open_metrics` with `metrics_mutex_` held
      */
-    void close()
+    void open_metrics_locked(const std::string &path, double summary_interval)
     {
-        if (file_.is_open())
-            file_.close();
+        EpochGuard guard;
+        const Config *config = this->config();
+        if (metrics_file_.is_open())
+        {
+            metrics_file_.close();
+            metrics_names_.close();
+        }
+        metrics_path_ = !path.empty() ? path : (!config->file_path.empty() ? config->file_path : config->name) + ".metrics";
+        summary_interval_ = summary_interval;
+        scalars_.clear();
+        scalar_names_.clear();
+        pending_scalars_ = 0;
+        last_summary_ = std::chrono::steady_clock::now();
+
+        if (fs::path(metrics_path_).has_parent_path())
+            fs::create_directories(fs::path(metrics_path_).parent_path());
+        const std::string names_path = metrics_path_ + ".names";
+        const bool fresh = config->mode == "w" || !fs::exists(metrics_path_) || fs::file_size(metrics_path_) == 0;
+        if (!fresh)
+        {
+            // Only append records to a series file of the same layout
+            MetricsHeader header{};
+            std::ifstream existing(metrics_path_, std::ios::binary);
+            if (!existing.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+                std::memcmp(header.magic, kMetricsMagic, sizeof(header.magic)) != 0 ||
+                header.version != kMetricsVersion || header.record_size != sizeof(MetricRecord))
+                throw std::runtime_error("Not a LightLog metrics file of version " + std::to_string(kMetricsVersion) +
+                                         ", refusing to append to it: " + metrics_path_);
+        }
+
+        // Appending to an existing series keeps its name ids, so reload the dictionary first
+        if (!fresh)
+        {
+            std::ifstream names_in(names_path);
+            for (std::string name; std::getline(names_in, name);)
+            {
+                scalars_.emplace(name, ScalarState{static_cast<uint32_t>(scalar_names_.size())});
+                scalar_names_.push_back(name);
+            }
+        }
+        const auto open_mode = std::ios::binary | (fresh ? std::ios::trunc : std::ios::app);
+        metrics_file_.open(metrics_path_, std::ios::out | open_mode);
+        metrics_names_.open(names_path, std::ios::out | (fresh ? std::ios::trunc : std::ios::app));
+        if (!metrics_file_.is_open() || !metrics_names_.is_open())
+        {
+            std::cerr << "Failed to open metrics file: " << metrics_path_ << std::endl;
+            metrics_file_.close();
+            metrics_names_.close();
+            return;
+        }
+        if (fresh)
+        {
+            scalars_.clear();
+            scalar_names_.clear();
+            MetricsHeader header{};
+            std::memcpy(header.magic, kMetricsMagic, sizeof(header.magic));
+            header.version = kMetricsVersion;
+            header.record_size = sizeof(MetricRecord);
+            metrics_file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        }
     }
 
+public:
     /**
-     * @brief Log a message with specified level and options
+     * @brief Log a one-line numerical summary of an array
      *
-     * @param msg The message to log
-     * @param level The log level for this message
-     * @param use_rank Whether to include rank information for this message
-     * @param new_file Optional new file to log this message to
+     * Statistics are computed natively with the GIL released (on several threads for large
+     * arrays), and only when the line will actually be written.
+     *
+     * @param name Label of the array in the log line
+     * @param array Any CPU array exposing the buffer protocol or DLPack
+     * @param level The log level for this message (default: 20 for INFO)
+     * @param threads Worker threads for large arrays (default: 0 for hardware concurrency)
      */
-    void log(const std::string &msg, int level, bool use_rank = false, const std::string &new_file = "")
+    void log_array(const std::string &name, const nb::ndarray<nb::ro, nb::device::cpu> &array, int level = 20,
+                   unsigned threads = 0)
     {
-        if (level >= level_)
-        {
-            if (log_rank_ != -1 && rank_ != log_rank_)
-                return; // only log on specific rank
+        if (!enabled(level))
+            return;
 
-            std::string formatted_msg = format_message(msg, level);
-            formatted_msg = (use_rank || use_rank_) ? "[" + std::to_string(rank_) + "/" + std::to_string(world_size_) + "] " + formatted_msg : formatted_msg;
+        std::vector<size_t> shape(array.ndim());
+        std::vector<int64_t> strides(array.ndim());
+        std::string line = name + ": shape=(";
+        for (size_t d = 0; d < array.ndim(); ++d)
+        {
+            shape[d] = array.shape(d);
+            strides[d] = array.stride(d);
+            line.append(d ? ", " : "").append(std::to_string(shape[d]));
+        }
+        line.append(array.ndim() == 1 ? ",)" : ")");
 
-            std::cout << formatted_msg;
+        const auto dtype = array.dtype();
+        const void *data = array.data();
+        std::optional<ArrayStats> stats;
+        const char *type_name = "unknown";
+        {
+            nb::gil_scoped_release release;
+            auto identity = [](auto v) { return v; };
+            auto summarize = [&](const char *type, const auto *typed, auto convert)
+            {
+                type_name = type;
+                stats = array_stats(typed, shape, strides, threads, convert);
+            };
+            using code = nb::dlpack::dtype_code;
+            const bool is_bool = dtype.code == static_cast<uint8_t>(code::Bool);
+            switch (static_cast<code>(dtype.code))
+            {
+            case code::Float:
+                if (dtype.bits == 64)
+                    summarize("float64", static_cast<const double *>(data), identity);
+                else if (dtype.bits == 32)
+                    summarize("float32", static_cast<const float *>(data), identity);
+                else if (dtype.bits == 16)
+                    summarize("float16", static_cast<const uint16_t *>(data), half_to_float);
+                break;
+            case code::Bfloat:
+                if (dtype.bits == 16)
+                    summarize("bfloat16", static_cast<const uint16_t *>(data), bfloat16_to_float);
+                break;
+            case code::Int:
+                if (dtype.bits == 8)
+                    summarize("int8", static_cast<const int8_t *>(data), identity);
+                else if (dtype.bits == 16)
+                    summarize("int16", static_cast<const int16_t *>(data), identity);
+                else if (dtype.bits == 32)
+                    summarize("int32", static_cast<const int32_t *>(data), identity);
+                else if (dtype.bits == 64)
+                    summarize("int64", static_cast<const int64_t *>(data), identity);
+                break;
+            case code::UInt:
+            case code::Bool:
+                if (dtype.bits == 8)
+                    summarize(is_bool ? "bool" : "uint8", static_cast<const uint8_t *>(data), identity);
+                else if (dtype.bits == 16)
+                    summarize("uint16", static_cast<const uint16_t *>(data), identity);
+                else if (dtype.bits == 32)
+                    summarize("uint32", static_cast<const uint32_t *>(data), identity);
+                else if (dtype.bits == 64)
+                    summarize("uint64", static_cast<const uint64_t *>(data), identity);
+                break;
+            default:
+                break; // complex and exotic types: shape only
+            }
+        }
 
-            if (!new_file.empty())
-                log_to_file(formatted_msg, new_file);
-            else if (file_.is_open())
-                file_ << formatted_msg;
+        line.append(" dtype=").append(type_name);
+        if (stats)
+        {
+            char buf[160];
+            snprintf(buf, sizeof(buf), " min=%.6g max=%.6g mean=%.6g std=%.6g nan=%llu inf=%llu",
+                     stats->count ? stats->min : NAN, stats->count ? stats->max : NAN,
+                     stats->count ? stats->mean : NAN, stats->std(),
+                     static_cast<unsigned long long>(stats->nan), static_cast<unsigned long long>(stats->inf));
+            line.append(buf);
         }
+        log(line + "\n", level);
     }
 
     /**
@@ -132,111 +2075,166 @@ public:
                      const std::string &auto_detect_env = "",
                      const int &log_rank = -1)
     {
-        name_ = !name.empty() ? name : name_;
-        mode_ = !mode.empty() ? mode : mode_;
-        if (!file_path.empty())
-        {
-            if (file_path != file_path_)
+        update_config([&](Config &config)
+                      {
+            config.name = !name.empty() ? name : config.name;
+            config.mode = !mode.empty() ? mode : config.mode;
+            if (!file_path.empty())
             {
-                file_path_ = file_path;
-                if (file_.is_open())
-                    file_.close();
-
-                open_file();
+                if (file_path != config.file_path)
+                {
+                    // Records still being formatted against the old snapshot go to the old file,
+                    // which is closed once that snapshot is reclaimed
+                    config.file_path = file_path;
+                    config.file = std::make_shared<FileSink>(config.file_path, config.mode);
+                    config.shard = std::hash<std::string>{}(file_path);
+                }
             }
-        }
-        level_ = level != -1 ? level : level_;
-        rank_ = rank != -1 ? rank : rank_;
-        world_size_ = world_size != -1 ? world_size : world_size_;
-        auto_detect_env_ = !auto_detect_env.empty() ? auto_detect_env : auto_detect_env_;
+            config.level = level != -1 ? level : config.level;
+            config.rank = rank != -1 ? rank : config.rank;
+            config.world_size = world_size != -1 ? world_size : config.world_size;
+            config.auto_detect_env = !auto_detect_env.empty() ? auto_detect_env : config.auto_detect_env;
 
-        use_rank_ = use_rank;
-        if (use_rank_)
-            std::tie(rank_, world_size_) = get_rank_and_world_size(rank, world_size, auto_detect_env);
+            config.use_rank = use_rank;
+            if (config.use_rank)
+                std::tie(config.rank, config.world_size) = get_rank_and_world_size(rank, world_size, auto_detect_env);
 
-        log_rank_ = (log_rank != -1) ? log_rank : log_rank_;
+            config.log_rank = (log_rank != -1) ? log_rank : config.log_rank; });
     }
 
 private:
-    std::string name_, file_path_, mode_, auto_detect_env_;
-    int level_, rank_, world_size_;
-    int log_rank_ = -1;
-    bool use_rank_;
-    std::ofstream file_;
+    // Settings snapshot, replaced as a whole by `update_config`; `config_mutex_` serializes writers
+    std::atomic<const Config *> config_{nullptr};
+    std::mutex config_mutex_;
 
-    /**
-     * @brief Open the log file
-     *
-     * Creates necessary directories and opens the file stream.
-     */
-    void open_file()
+    // Guards the process-wide console, so every record reaches it in one uninterrupted write
+    static inline std::mutex console_mutex_;
+
+    // The progress line shown in place on the terminal, redrawn below console records
+    struct TerminalBar
     {
-        fs::create_directories(fs::path(file_path_).parent_path());
-        file_.open(file_path_, mode_ == "w" ? std::ios::trunc : std::ios::app);
-        if (!file_.is_open())
-            std::cerr << "Failed to open file: " << file_path_ << std::endl;
-    }
+        std::string text; // carriage return, the line and an erase to its end; empty if none is shown
+        const CppLogger *owner;
+        std::string key;
+    };
+    static inline TerminalBar bar_{}; // guarded by `console_mutex_`
+
+    struct ScalarState
+    {
+        uint32_t id;
+        double last = 0.0;
+        int64_t step = 0;
+        double sum = 0.0;
+        uint64_t count = 0; // samples since the last summary line
+    };
+    std::mutex metrics_mutex_; // guards the series file and the per-series state below
+    std::string metrics_path_;
+    std::ofstream metrics_file_, metrics_names_;
+    std::unordered_map<std::string, ScalarState> scalars_;
+    std::vector<std::string> scalar_names_; // id -> name
+    uint64_t pending_scalars_ = 0;
+    double summary_interval_ = 60.0;
+    std::chrono::steady_clock::time_point last_summary_;
+
+    // Writer pool shared by all loggers with a latency budget, started on first use
+    static inline std::atomic<AsyncWriter *> async_writer_{nullptr};
+    static inline std::mutex async_mutex_; // serializes starting the pool and configuring it
+    static inline size_t async_capacity_ = 8192, async_priority_capacity_ = 1024, async_threads_ = 1;
+    static inline std::chrono::nanoseconds async_spin_{0}; // polling before a writer parks
+    static inline HugePages async_huge_pages_ = HugePages::kOff;
+    static inline std::atomic<uint64_t> next_sequence_{0}; // "seq=" stamps while a priority lane is in use
+    static inline std::atomic<double> drop_report_interval_{1.0};
+    static inline std::atomic<bool> drops_pending_{false}; // some logger has unreported drops
+    std::atomic<uint64_t> dropped_{0}, dropped_unreported_{0};
+
+    std::mutex warnings_mutex_; // guards `warnings_seen_`
+    std::unordered_set<std::string> warnings_seen_; // "category\0filename:lineno" of logged warnings
+
+    std::mutex progress_mutex_; // guards `progress_`
+    std::unordered_map<std::string, ProgressState> progress_;
 
     /**
      * @brief Format a log message
      *
+     * @param result Buffer receiving the formatted message (cleared first, capacity is kept)
+     * @param config The settings snapshot the message is formatted with
      * @param msg The raw message
      * @param level The log level
-     * @return std::string The formatted message
+     * @param rank_prefix Rendered `[rank/world_size] ` label, or empty
+     * @param location Rendered caller location inserted before the message
+     * @param identity Pre-rendered process and thread identity fields inserted before the message
+     * @param context Pre-rendered contextual fields inserted before the message
+     * @param multiline How physical lines after the first are prefixed
      */
-    [[nodiscard]] std::string format_message(const std::string &msg, int level) const
+    void format_message(std::string &result, const Config &config, const std::string &msg, int level,
+                        std::string_view rank_prefix = {}, std::string_view location = {}, std::string_view identity = {},
+                        std::string_view context = {}, Multiline multiline = Multiline::kFirst) const
     {
-        if (level == 0)
+        // Pre-allocate string with estimated size
+        result.clear();
+        result.reserve(64 + rank_prefix.size() + config.name.size() + location.size() + identity.size() + context.size() + msg.size());
+        result.append(rank_prefix);
+
+        if (level != 0)
         {
-            return msg;
-        }
+            // Get current time and milliseconds
+            auto now = std::chrono::system_clock::now();
+            auto time_t_now = std::chrono::system_clock::to_time_t(now);
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
 
-        // Pre-allocate string with estimated size
-        std::string result;
-        result.reserve(64 + name_.size() + msg.size());
-
-        // Get current time and milliseconds
-        auto now = std::chrono::system_clock::now();
-        auto time_t_now = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
-
-        // Format date and time
-        char time_buf[20];
-        std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M:%S", std::localtime(&time_t_now));
-        result.append(time_buf);
-
-        // Append milliseconds
-        char ms_buf[5];
-        snprintf(ms_buf, sizeof(ms_buf), ",%03lu", static_cast<unsigned long>(ms));
-        result.append(ms_buf);
-
-        // Append the rest of the message
-        result.append(" | ");
-        result.append(name_);
-        result.append(" | ");
-        result.append(get_level_str(level));
-        result.append(" | ");
-        result.append(msg);
+            // Format date and time
+            char time_buf[20];
+            std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M:%S", std::localtime(&time_t_now));
+            result.append(time_buf);
 
-        return result;
-    }
+            // Append milliseconds
+            char ms_buf[5];
+            snprintf(ms_buf, sizeof(ms_buf), ",%03lu", static_cast<unsigned long>(ms));
+            result.append(ms_buf);
 
-    // Helper function to find the exact level value
-    const std::string get_level_str(int level) const
-    {
-        static constexpr std::pair<int, const char *> level_map[] = {
-            {0, "NOTSET"}, {10, "DEBUG"}, {20, "INFO"}, {30, "WARNING"}, {40, "ERROR"}, {50, "CRITICAL"}};
-        const auto size = sizeof(level_map) / sizeof(level_map[0]);
+            // Append the rest of the message
+            result.append(" | ");
+            result.append(config.name);
+            LevelRegistry::append_segment(result, level);
+            result.append(location);
+            result.append(identity);
+            result.append(context);
+        }
+
+        // Only the first physical line carries the prefix unless the message spans several lines
+        const char *nl = static_cast<const char *>(std::memchr(msg.data(), '\n', msg.size()));
+        if (multiline == Multiline::kFirst || result.empty() || !nl || nl + 1 == msg.data() + msg.size())
+        {
+            result.append(msg);
+            return;
+        }
+
+        // Every following line gets the prefix again, or a continuation of the same width that
+        // keeps the rank label and aligns a bar under the message column
+        std::string continuation(result);
+        if (multiline == Multiline::kIndent && continuation.size() > rank_prefix.size() + 2)
+        {
+            std::fill(continuation.begin() + static_cast<ptrdiff_t>(rank_prefix.size()), continuation.end() - 2, ' ');
+            continuation[continuation.size() - 2] = '|';
+        }
+        const size_t lines = 1 + static_cast<size_t>(std::count(nl, msg.data() + msg.size(), '\n'));
+        result.reserve(result.size() + msg.size() + lines * continuation.size());
 
-        for (const auto &pair : level_map)
+        const char *begin = msg.data(), *end = msg.data() + msg.size();
+        while (true)
         {
-            if (pair.first == level)
+            result.append(begin, static_cast<size_t>(nl + 1 - begin));
+            begin = nl + 1;
+            if (begin == end)
+                break;
+            result.append(continuation);
+            nl = static_cast<const char *>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+            if (!nl)
             {
-                return pair.second;
+                result.append(begin, static_cast<size_t>(end - begin));
+                break;
             }
         }
-
-        return ""; // or throw an exception if level is not found
     }
 
     /**
@@ -287,19 +2285,55 @@ private:
         return {0, 1}; // Default values if no detection method succeeds
     }
 
+    /**
+     * @brief Write one INFO line with the latest value and running mean of every updated series
+     */
+    void log_scalar_summary()
+    {
+        std::string line = "metrics";
+        char buf[64];
+        for (const auto &name : scalar_names_)
+        {
+            ScalarState &state = scalars_[name];
+            if (state.count == 0)
+                continue;
+            snprintf(buf, sizeof(buf), "=%.6g (step %lld, mean %.6g over %llu)", state.last,
+                     static_cast<long long>(state.step), state.sum / static_cast<double>(state.count),
+                     static_cast<unsigned long long>(state.count));
+            line.append(" | ").append(name).append(buf);
+            state.sum = 0.0;
+            state.count = 0;
+        }
+        pending_scalars_ = 0;
+        last_summary_ = std::chrono::steady_clock::now();
+        log(line + "\n", 20);
+    }
+
+    /**
+     * @brief UTF-8 view of a Python `str` (valid while the object is alive)
+     */
+    static std::string_view utf8(nb::handle str)
+    {
+        Py_ssize_t size = 0;
+        const char *data = PyUnicode_AsUTF8AndSize(str.ptr(), &size);
+        if (!data)
+            throw nb::python_error();
+        return {data, static_cast<size_t>(size)};
+    }
+
     /**
      * @brief Log a message to a specific file
      *
      * @param msg The formatted message to log
      * @param file_path The path to the file to log to
      */
-    void log_to_file(const std::string &msg, const std::string &file_path)
+    void log_to_file(std::string_view msg, const std::string &file_path)
     {
         fs::create_directories(fs::path(file_path).parent_path());
         std::ofstream file_stream(file_path, std::ios::app);
         if (file_stream.is_open())
         {
-            file_stream << msg;
+            file_stream.write(msg.data(), static_cast<std::streamsize>(msg.size()));
             file_stream.close();
         }
         else
@@ -307,6 +2341,311 @@ private:
     }
 };
 
+inline void LevelControl::add(CppLogger *logger)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    loggers_.push_back(logger);
+    if (running_)
+        apply(logger);
+}
+
+inline void LevelControl::remove(CppLogger *logger)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    loggers_.erase(std::remove(loggers_.begin(), loggers_.end(), logger), loggers_.end());
+}
+
+/**
+ * @brief Flush every live logger (all of them are registered here), e.g. before the process dies
+ */
+inline void LevelControl::flush_all()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (CppLogger *logger : loggers_)
+        logger->flush();
+}
+
+/**
+ * @brief Call `fn` for every live logger unless the registry is busy (never blocks)
+ */
+template <typename Fn>
+inline bool LevelControl::try_for_each(Fn &&fn)
+{
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock())
+        return false;
+    for (CppLogger *logger : loggers_)
+        fn(logger);
+    return true;
+}
+
+inline void LevelControl::start(bool use_signal, const std::string &control_file, double poll_interval, int signal_level,
+                                int clear_signal)
+{
+    if (clear_signal != 0 && !use_signal)
+        throw std::invalid_argument("clear_signal needs signal=True");
+#ifdef _WIN32
+    if (use_signal)
+        throw std::invalid_argument("SIGUSR2 is not available on Windows; use a control file instead");
+#else
+    if (clear_signal != 0 && (clear_signal < 1 || clear_signal >= NSIG || clear_signal == SIGUSR2 ||
+                              clear_signal == SIGKILL || clear_signal == SIGSTOP))
+        throw std::invalid_argument("clear_signal must be a catchable signal other than SIGUSR2, got " +
+                                    std::to_string(clear_signal));
+#endif
+    stop();
+    std::lock_guard<std::mutex> lock(mutex_);
+    use_signal_ = use_signal;
+    control_file_ = control_file.empty() ? std::string() : fs::absolute(control_file).lexically_normal().string();
+    poll_interval_ = poll_interval > 0 ? poll_interval : 1.0;
+    signal_level_ = signal_level;
+    signal_active_ = false;
+    control_exists_ = false;
+    file_level_.reset();
+    file_levels_.clear();
+#ifndef _WIN32
+    if (use_signal_)
+    {
+        if (::pipe(pipe_) != 0)
+            throw std::runtime_error("Failed to create the level control pipe");
+        for (int fd : pipe_)
+        {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        struct sigaction action = {};
+        action.sa_handler = &LevelControl::on_signal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        clear_signal_ = clear_signal;
+        ::sigaction(SIGUSR2, &action, &previous_usr2_);
+        if (clear_signal)
+            ::sigaction(clear_signal, &action, &previous_clear_);
+    }
+    static const bool registered = []
+    {
+        // The thread does not exist in a forked child: forget it there (see `after_fork_child`)
+        pthread_atfork(nullptr, nullptr, &LevelControl::after_fork_child);
+        return true;
+    }();
+    (void)registered;
+#endif
+    if (!control_file_.empty())
+        reload_control_file();
+    for (CppLogger *logger : loggers_)
+        apply(logger);
+    running_ = true;
+    stopping_ = false;
+    thread_ = std::thread(&LevelControl::run);
+}
+
+inline void LevelControl::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_)
+        {
+            // Nothing runs, but a forked child may still carry the overrides of its parent
+            for (CppLogger *logger : loggers_)
+                logger->set_level_override(-1);
+            return;
+        }
+        stopping_ = true;
+    }
+    wake_.notify_all();
+#ifndef _WIN32
+    if (use_signal_)
+        on_signal(0); // wake the poll()
+#endif
+    thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+#ifndef _WIN32
+    restore_signals();
+#endif
+    running_ = false;
+    signal_active_ = false;
+    file_level_.reset();
+    file_levels_.clear();
+    for (CppLogger *logger : loggers_)
+        apply(logger); // restores the loggers' own levels
+}
+
+inline void LevelControl::run()
+{
+    ThreadPolicy::apply_current("level control");
+    while (true)
+    {
+        wait();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_)
+            return;
+        bool changed = false;
+#ifndef _WIN32
+        if (use_signal_)
+        {
+            char bytes[64];
+            for (ssize_t n; (n = ::read(pipe_[0], bytes, sizeof(bytes))) > 0;)
+            {
+                for (ssize_t i = 0; i < n; ++i)
+                {
+                    if (bytes[i] == kToggle)
+                    {
+                        signal_active_ = !signal_active_;
+                        changed = true;
+                    }
+                    else if (bytes[i] == kSet || bytes[i] == kClear)
+                    {
+                        changed |= signal_active_ != (bytes[i] == kSet);
+                        signal_active_ = bytes[i] == kSet;
+                    }
+                }
+            }
+        }
+#endif
+        if (!control_file_.empty())
+        {
+            std::error_code error;
+            const bool exists = fs::exists(control_file_, error);
+            const fs::file_time_type mtime = exists ? fs::last_write_time(control_file_, error) : fs::file_time_type{};
+            if (exists != control_exists_ || mtime != control_mtime_)
+            {
+                reload_control_file();
+                changed = true;
+            }
+        }
+        if (changed)
+        {
+            for (CppLogger *logger : loggers_)
+                apply(logger);
+        }
+    }
+}
+
+inline void LevelControl::wait()
+{
+    const auto timeout = std::chrono::duration<double>(poll_interval_);
+#ifndef _WIN32
+    if (use_signal_)
+    {
+        struct pollfd fd = {pipe_[0], POLLIN, 0};
+        ::poll(&fd, 1, control_file_.empty() ? -1 : static_cast<int>(timeout.count() * 1000));
+        return;
+    }
+#endif
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_.wait_for(lock, timeout, [] { return stopping_; });
+}
+
+inline void LevelControl::reload_control_file()
+{
+    std::error_code error;
+    control_exists_ = fs::exists(control_file_, error);
+    control_mtime_ = control_exists_ ? fs::last_write_time(control_file_, error) : fs::file_time_type{};
+    file_level_.reset();
+    file_levels_.clear();
+
+    std::ifstream in(control_file_);
+    for (std::string line; std::getline(in, line);)
+    {
+        std::string_view text(line);
+        text = text.substr(0, text.find('#'));
+        const size_t eq = text.find('=');
+        std::string_view name = eq == std::string_view::npos ? std::string_view() : text.substr(0, eq);
+        std::string_view value = eq == std::string_view::npos ? text : text.substr(eq + 1);
+        auto trim = [](std::string_view v)
+        {
+            while (!v.empty() && std::isspace(static_cast<unsigned char>(v.front())))
+                v.remove_prefix(1);
+            while (!v.empty() && std::isspace(static_cast<unsigned char>(v.back())))
+                v.remove_suffix(1);
+            return v;
+        };
+        name = trim(name);
+        const std::optional<int> level = parse_level(trim(value));
+        if (!level)
+            continue;
+        if (name.empty() || name == "*")
+            file_level_ = level;
+        else
+            file_levels_[std::string(name)] = *level;
+    }
+}
+
+inline std::optional<int> LevelControl::parse_level(std::string_view text)
+{
+    if (text.empty())
+        return std::nullopt;
+    if (int level = level_from_name(text); level >= 0)
+        return level;
+    std::string upper(text);
+    for (char &c : upper)
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    if (int level = level_from_name(upper); level >= 0)
+        return level;
+    int level = 0;
+    if (!parse_fixed_digits(upper.data(), upper.size(), level))
+        return std::nullopt;
+    return level;
+}
+
+/**
+ * @brief Set `logger` to the level the active overrides ask for, or back to its own level
+ */
+inline void LevelControl::apply(CppLogger *logger)
+{
+    std::optional<int> target;
+    if (signal_active_)
+        target = signal_level_;
+    else if (auto it = file_levels_.find(logger->name()); it != file_levels_.end())
+        target = it->second;
+    else
+        target = file_level_;
+
+    logger->set_level_override(target.value_or(-1));
+}
+
+#ifndef _WIN32
+/**
+ * @brief Put back the signal handlers replaced by `start` and close the self-pipe
+ */
+inline void LevelControl::restore_signals()
+{
+    if (!use_signal_)
+        return;
+    ::sigaction(SIGUSR2, &previous_usr2_, nullptr);
+    if (clear_signal_)
+        ::sigaction(clear_signal_, &previous_clear_, nullptr);
+    clear_signal_ = 0;
+    ::close(pipe_[0]);
+    ::close(pipe_[1]);
+    pipe_[0] = pipe_[1] = -1;
+    use_signal_ = false;
+}
+
+/**
+ * @brief `fork()` child handler: the thread is gone, so reset its state without joining it
+ *
+ * The mutex may have been held by a parent thread at the fork and is recreated; the old
+ * `std::thread` is overwritten without running its destructor, which would terminate the
+ * process for a joinable thread. Loggers keep the overrides in effect at the fork until the
+ * child enables the control again or disables it.
+ */
+inline void LevelControl::after_fork_child()
+{
+    new (&mutex_) std::mutex();
+    new (&wake_) std::condition_variable();
+    new (&thread_) std::thread();
+    if (running_)
+        restore_signals(); // the pipe is shared with the parent, whose thread would read from it
+    running_ = false;
+    stopping_ = false;
+    signal_active_ = false;
+    file_level_.reset();
+    file_levels_.clear();
+}
+#endif
+
 /**
  * @brief Nanobind module definition
  *
@@ -336,8 +2675,8 @@ NB_MODULE(cpplightlog, m)
             logger = _lightlog.CppLogger("MyLogger", "logfile.log", level=20)
             
             # Log messages
-            logger.log("This is an info message", 20)
-            logger.log("This is a warning", 30)
+            logger.info("This is an info message")
+            logger.log("This is a warning", level=30)
             
             # Close the logger
             logger.close()
@@ -387,13 +2726,100 @@ NB_MODULE(cpplightlog, m)
                  This method should be called when you're done logging to ensure all data is written
                  and system resources are properly released.
              )pbdoc")
-        .def("log", &CppLogger::log,
+        .def("log", &CppLogger::log_args,
+             nb::arg("args"),
+             nb::arg("sep") = " ",
+             nb::arg("end") = "\n",
+             nb::arg("level") = 0,
+             nb::arg("use_rank") = false,
+             nb::arg("new_file_path") = nb::none(),
+             R"pbdoc(
+                 Log the given objects, joined like `print()`, at the given level.
+
+                 Args:
+                     *args: The message components; non-string objects are converted with `str()`.
+                     sep (str, optional): Separator between the components. Defaults to " ".
+                     end (str, optional): String appended after the message. Defaults to "\n".
+                     level (int, optional): The log level for this message. Defaults to 0 (NOTSET,
+                         written without a header).
+                     use_rank (bool, optional): Include rank information for this message. Defaults to False.
+                     new_file_path (str, optional): Also append this message to the given file. Defaults to None.
+
+                 The level is checked before the arguments are converted, so a filtered call costs
+                 only the (vectorcall) argument parsing. The level must be passed by keyword: a
+                 positional one is logged as part of the message. The former `log(msg, level)` entry
+                 point taking one joined string is now `log_message(msg, level, ...)`.
+
+                 Example:
+                     >>> logger.log("Value:", 42, "Threshold:", 100, sep=", ", level=lightlog.INFO)
+             )pbdoc")
+        .def("debug", [](CppLogger &self, nb::args args, nb::handle sep, nb::handle end, bool use_rank, nb::handle new_file_path)
+             { self.log_args(args, sep, end, 10, use_rank, new_file_path); },
+             nb::arg("args"),
+             nb::arg("sep") = " ",
+             nb::arg("end") = "\n",
+             nb::arg("use_rank") = false,
+             nb::arg("new_file_path") = nb::none(),
+             R"pbdoc(
+                 Log the given objects, joined like `print()`, at the DEBUG level.
+
+                 Takes the same arguments as `log()` except `level`.
+             )pbdoc")
+        .def("info", [](CppLogger &self, nb::args args, nb::handle sep, nb::handle end, bool use_rank, nb::handle new_file_path)
+             { self.log_args(args, sep, end, 20, use_rank, new_file_path); },
+             nb::arg("args"),
+             nb::arg("sep") = " ",
+             nb::arg("end") = "\n",
+             nb::arg("use_rank") = false,
+             nb::arg("new_file_path") = nb::none(),
+             R"pbdoc(
+                 Log the given objects, joined like `print()`, at the INFO level.
+
+                 Takes the same arguments as `log()` except `level`.
+             )pbdoc")
+        .def("warning", [](CppLogger &self, nb::args args, nb::handle sep, nb::handle end, bool use_rank, nb::handle new_file_path)
+             { self.log_args(args, sep, end, 30, use_rank, new_file_path); },
+             nb::arg("args"),
+             nb::arg("sep") = " ",
+             nb::arg("end") = "\n",
+             nb::arg("use_rank") = false,
+             nb::arg("new_file_path") = nb::none(),
+             R"pbdoc(
+                 Log the given objects, joined like `print()`, at the WARNING level.
+
+                 Takes the same arguments as `log()` except `level`.
+             )pbdoc")
+        .def("error", [](CppLogger &self, nb::args args, nb::handle sep, nb::handle end, bool use_rank, nb::handle new_file_path)
+             { self.log_args(args, sep, end, 40, use_rank, new_file_path); },
+             nb::arg("args"),
+             nb::arg("sep") = " ",
+             nb::arg("end") = "\n",
+             nb::arg("use_rank") = false,
+             nb::arg("new_file_path") = nb::none(),
+             R"pbdoc(
+                 Log the given objects, joined like `print()`, at the ERROR level.
+
+                 Takes the same arguments as `log()` except `level`.
+             )pbdoc")
+        .def("critical", [](CppLogger &self, nb::args args, nb::handle sep, nb::handle end, bool use_rank, nb::handle new_file_path)
+             { self.log_args(args, sep, end, 50, use_rank, new_file_path); },
+             nb::arg("args"),
+             nb::arg("sep") = " ",
+             nb::arg("end") = "\n",
+             nb::arg("use_rank") = false,
+             nb::arg("new_file_path") = nb::none(),
+             R"pbdoc(
+                 Log the given objects, joined like `print()`, at the CRITICAL level.
+
+                 Takes the same arguments as `log()` except `level`.
+             )pbdoc")
+        .def("log_message", &CppLogger::log,
              nb::arg("msg"),
              nb::arg("level"),
              nb::arg("use_rank") = false,
              nb::arg("new_file") = "",
              R"pbdoc(
-                 Log a message with specified level and options.
+                 Log a single, already joined message string with specified level and options.
 
                  Args:
                      msg (str): The message to log.
@@ -405,6 +2831,38 @@ NB_MODULE(cpplightlog, m)
                  before actually logging the message. If a new_file is specified, the message will be
                  logged to that file instead of the default log file.
              )pbdoc")
+        .def("log_lines", &CppLogger::log_lines,
+             nb::arg("msg"),
+             nb::arg("level"),
+             nb::arg("use_rank") = false,
+             nb::arg("new_file") = "",
+             R"pbdoc(
+                 Log text made of several lines, repeating the full prefix on every line.
+
+                 Args:
+                     msg (str): One or more lines to log.
+                     level (int): The log level for these lines.
+                     use_rank (bool, optional): Whether to include rank information. Defaults to False.
+                     new_file (str, optional): Optional new file to log these lines to. Defaults to "".
+
+                 Equivalent to logging each line separately, but formatted in one pass and written
+                 in one call, regardless of the `multiline` setting.
+             )pbdoc")
+        .def_prop_rw("multiline", &CppLogger::multiline, &CppLogger::set_multiline,
+                     R"pbdoc(
+                         How messages spanning several lines are prefixed.
+
+                         - "first": only the first line carries the prefix (default).
+                         - "prefix": every physical line carries the full prefix, so each line can be
+                           grepped, sorted and merged on its own.
+                         - "indent": lines after the first carry the rank label and an indented `| `
+                           aligned under the message column.
+
+                         Newlines are located with `memchr`, and all lines are formatted in one pass.
+
+                         Raises:
+                             ValueError: If an unknown mode is given.
+                     )pbdoc")
         .def("flush", &CppLogger::flush,
              R"pbdoc(
                  Flush the logger, writing any buffered data.
@@ -413,6 +2871,230 @@ NB_MODULE(cpplightlog, m)
                  output stream (file or console). It's useful when you need to ensure all logs
                  are written before a potential crash or when you're about to read the log file.
              )pbdoc")
+        .def("log_exception", &CppLogger::log_exception,
+             nb::arg("msg"),
+             nb::arg("level") = 40,
+             nb::arg("exc") = nb::none(),
+             nb::arg("use_rank") = false,
+             nb::arg("new_file") = "",
+             R"pbdoc(
+                 Log a message followed by an exception and its traceback as a single record.
+
+                 Args:
+                     msg (str): The message to log.
+                     level (int, optional): The log level for this message. Defaults to 40 (ERROR).
+                     exc (BaseException, optional): The exception to render. Defaults to None (the
+                         exception currently being handled).
+                     use_rank (bool, optional): Whether to include rank information. Defaults to False.
+                     new_file (str, optional): Optional new file to log this message to. Defaults to "".
+
+                 The traceback is rendered natively in the layout of `traceback.print_exception`
+                 (without source lines), including chained exceptions, and written to every sink
+                 in one write so it cannot interleave with other threads' output.
+             )pbdoc")
+        .def_prop_rw("capture_location", &CppLogger::capture_location, &CppLogger::set_capture_location,
+                     R"pbdoc(
+                         Whether formatted lines include the caller's location as `file:line:function`.
+
+                         The location is inserted after the level, e.g.
+                         `2024-09-18 04:17:23,997 | LogName | INFO | train.py:42:main | message`.
+                         File and function names are cached per code object, so enabling it costs
+                         well under a microsecond per line. Defaults to False.
+                     )pbdoc")
+        .def_prop_rw("latency_budget", &CppLogger::latency_budget, &CppLogger::set_latency_budget,
+                     R"pbdoc(
+                         Longest time in microseconds a logging call may spend handing its record over.
+
+                         When positive, records are formatted in the calling thread and queued for a
+                         background writer thread, so a slow disk or a blocked stdout pipe never stalls
+                         the caller. A record that cannot be queued within the budget (the queue stayed
+                         full) is dropped and counted in `dropped`; once the queue drains, a WARNING line
+                         "N records dropped" is written to the logger's sinks. `flush()` waits for the
+                         queue. Queued records go to the sinks that were configured when they were
+                         logged, even if the logger is reconfigured before they are written. The first
+                         record queued to each of the writer's queues maps and initializes that queue in
+                         the calling thread (so its memory lands on that thread's NUMA node), which can
+                         take longer than the budget once; log a record at startup to pay it early.
+                         Defaults to 0 (write synchronously).
+
+                         Raises:
+                             ValueError: If the budget is negative.
+                     )pbdoc")
+        .def_prop_rw("priority_level", &CppLogger::priority_level, &CppLogger::set_priority_level,
+                     R"pbdoc(
+                         Lowest level of queued records that bypass the backlog, e.g. 40 (ERROR).
+
+                         With a `latency_budget`, such records go to a separate lane that the writer
+                         thread always empties before the next normal record, and the sinks are flushed
+                         right after each of them, so a crash line reaches the file even behind megabytes
+                         of queued DEBUG output. Because records then leave in a different order than
+                         they were logged, every formatted line of the logger carries a process-wide
+                         `seq=N | ` field after the identity fields (progress lines and "N records
+                         dropped" reports included); sorting by it restores the logging order. Defaults
+                         to 0 (no priority lane).
+                     )pbdoc")
+        .def_prop_ro("dropped", &CppLogger::dropped,
+                     R"pbdoc(
+                         Number of records dropped so far because the latency budget was exceeded.
+                     )pbdoc")
+        .def_prop_rw("color", &CppLogger::color, &CppLogger::set_color,
+                     R"pbdoc(
+                         Color console records by level: "auto", "always" or "never".
+
+                         The colors come from the level table (see `add_level`) and are only written to
+                         the console, never to files. "auto" colors when stdout is a terminal and the
+                         `NO_COLOR` environment variable is unset; the check runs once when the mode is
+                         set. Defaults to "auto".
+
+                         Raises:
+                             ValueError: If the mode is unknown.
+                     )pbdoc")
+        .def_prop_rw("sinks", &CppLogger::sinks, &CppLogger::set_sinks,
+                     R"pbdoc(
+                         Level-routed sinks as a list of `(target, min_level, max_level)` tuples.
+
+                         `target` is "console" or the absolute path of a file written in addition to
+                         the logger's own file, e.g. `[("console", 20, 2**31 - 1),
+                         ("/logs/errors.log", 30, 2**31 - 1)]`. Each record is formatted once and the
+                         same text is written to every sink whose range contains its level. The console
+                         receives every level unless it is listed. Defaults to [("console", -2**31,
+                         2**31 - 1)].
+
+                         Raises:
+                             ValueError: If a target is listed twice or is the logger's own file, or
+                                 if a `min_level` is above its `max_level`.
+                     )pbdoc")
+        .def_prop_rw("identity_fields", &CppLogger::identity_fields, &CppLogger::set_identity_fields,
+                     R"pbdoc(
+                         Comma-separated process and thread identity fields added to formatted lines.
+
+                         Any of `pid`, `tid` (the OS thread id) and `thread` (the Python thread name),
+                         rendered as e.g. `pid=4242 tid=4250 thread=Loader-1 | ` after the caller
+                         location. The text is cached per thread and only re-rendered after a thread
+                         rename or a fork. Defaults to "" (no fields).
+
+                         Raises:
+                             ValueError: If an unknown field name is given.
+                     )pbdoc")
+        .def("log_warning", &CppLogger::log_warning,
+             nb::arg("message"),
+             nb::arg("category"),
+             nb::arg("filename"),
+             nb::arg("lineno"),
+             nb::arg("dedup") = true,
+             R"pbdoc(
+                 Log a Python warning as `filename:lineno: Category: message` at WARNING level.
+
+                 Args:
+                     message (str): The warning text.
+                     category (str): Name of the warning class, e.g. "DeprecationWarning".
+                     filename (str): File that triggered the warning.
+                     lineno (int): Line that triggered the warning.
+                     dedup (bool, optional): Only log the first warning of each (category, filename,
+                         lineno), tracked in a native hash set. Defaults to True.
+
+                 Returns:
+                     bool: Whether a line was written.
+             )pbdoc")
+        .def("progress", &CppLogger::progress,
+             nb::arg("key"),
+             nb::arg("current"),
+             nb::arg("total") = 0.0,
+             nb::arg("extra") = "",
+             nb::arg("level") = 20,
+             nb::arg("interval") = 10.0,
+             nb::arg("step") = 0.0,
+             R"pbdoc(
+                 Report the progress of a long-running loop without flooding the log files.
+
+                 Args:
+                     key (str): Name of the progress bar, used as its label.
+                     current (float): Units done so far.
+                     total (float, optional): Units in total. Defaults to 0 (unknown: no percentage or ETA).
+                     extra (str, optional): Text appended to the line, e.g. "loss=0.31". Defaults to "".
+                     level (int, optional): The log level of the lines. Defaults to 20 (INFO).
+                     interval (float, optional): Seconds between lines written to files. Defaults to 10.
+                     step (float, optional): Also write a line every `step` percentage points. Defaults
+                         to 0 (disabled).
+
+                 Lines look like `train: 45% 450/1000 [00:12<00:15, 37.5 it/s] loss=0.31`. On a
+                 terminal the console line is updated in place with a carriage return (at most
+                 every 100 ms); files, and a console redirected to a file or pipe, only get a line on
+                 the first call, every `interval` seconds or `step` percent, and when `current`
+                 reaches `total`. Rate and ETA are computed natively. Calls that write nothing
+                 still take a lock and look up `key`, but format nothing. Console records logged
+                 while a bar is shown take its line, and the bar is redrawn below them. Keys not
+                 updated for an hour, and the least recently used beyond 1024 keys, are forgotten;
+                 a forgotten key starts over (and writes a line) when it is used again. With a
+                 `latency_budget`, the lines go through the writer queue like any record (and may be
+                 dropped); only the in-place terminal redraw is written synchronously by the caller.
+             )pbdoc")
+        .def("open_metrics", &CppLogger::open_metrics,
+             nb::arg("path") = "",
+             nb::arg("summary_interval") = 60.0,
+             R"pbdoc(
+                 Open the binary series file used by `log_scalar` and `log_scalars`.
+
+                 Args:
+                     path (str, optional): Path of the series file. Defaults to "" (the log file path
+                         plus ".metrics", or "<name>.metrics" when logging to the console only).
+                     summary_interval (float, optional): Seconds between human-readable summary lines
+                         written to the normal sinks at INFO level. 0 disables them. Defaults to 60.
+
+                 The file holds a 16-byte header followed by fixed-width 32-byte records
+                 (name id, step, value, timestamp in ns); the name dictionary is written to
+                 "<path>.names". Use `lightlog.read_scalars` to load it. Calling `log_scalar`
+                 without opening first uses the defaults.
+
+                 Raises:
+                     RuntimeError: If the file is not empty and its header is not that of a
+                         series file of this version (only with mode 'a', which appends to it).
+             )pbdoc")
+        .def("log_scalar", &CppLogger::log_scalar,
+             nb::arg("name"),
+             nb::arg("value"),
+             nb::arg("step"),
+             R"pbdoc(
+                 Append one scalar sample to the binary series file.
+
+                 Args:
+                     name (str): Name of the series.
+                     value (float): The sample value.
+                     step (int): Training step or any other increasing counter.
+             )pbdoc")
+        .def("log_scalars", [](CppLogger &self, const nb::dict &scalars, int64_t step)
+             {
+                 for (auto [name, value] : scalars)
+                     self.log_scalar(nb::cast<std::string>(name), nb::cast<double>(value), step); },
+             nb::arg("scalars"),
+             nb::arg("step"),
+             R"pbdoc(
+                 Append several scalar samples sharing one step.
+
+                 Args:
+                     scalars (dict[str, float]): Series names mapped to their values.
+                     step (int): Training step or any other increasing counter.
+             )pbdoc")
+        .def("log_array", &CppLogger::log_array,
+             nb::arg("name"),
+             nb::arg("array"),
+             nb::arg("level") = 20,
+             nb::arg("threads") = 0,
+             R"pbdoc(
+                 Log a one-line numerical summary of an array.
+
+                 Args:
+                     name (str): Label of the array in the log line.
+                     array: Any CPU array supporting the buffer protocol or DLPack (NumPy arrays,
+                         CPU PyTorch tensors, memoryviews, ...).
+                     level (int, optional): The log level for this message. Defaults to 20 (INFO).
+                     threads (int, optional): Worker threads for large arrays. Defaults to 0 (all cores).
+
+                 The line holds the shape, dtype, min, max, mean and standard deviation of the finite
+                 elements, and the number of NaN and infinite elements, e.g.
+                 `grad: shape=(1024, 512) dtype=float32 min=-0.8 max=0.7 mean=1.2e-05 std=0.02 nan=0 inf=0`.
+                 Nothing is computed when the message would be filtered out by the level.
+             )pbdoc")
         .def("reconfigure", &CppLogger::reconfigure,
              nb::arg("name") = "",
              nb::arg("file_path") = "",
@@ -449,4 +3131,216 @@ NB_MODULE(cpplightlog, m)
                         - 40: ERROR
                         - 50: CRITICAL
             )pbdoc");
-}
\ No newline at end of file
+
+    nb::class_<PrintRouter>(m, "PrintRouter",
+                            R"pbdoc(
+                                `sys.stdout` replacement installed by `_push_print_target`.
+
+                                `write` goes to the logger bound in the calling thread or asyncio task, or
+                                to the original stream when none is bound; other attributes come from the
+                                original stream.
+                            )pbdoc")
+        .def("write", &PrintRouter::write, nb::arg("text"))
+        .def("flush", &PrintRouter::flush)
+        .def("__getattr__", &PrintRouter::getattr, nb::arg("name"));
+
+    m.def("_push_print_target", &PrintRouter::push,
+          nb::arg("target"),
+          R"pbdoc(
+            Send `print()` output of the calling thread or task to `target` and return the
+            `contextvars.Token` that `_pop_print_target` needs. Installs the router as `sys.stdout`
+            if it is not already.
+          )pbdoc");
+
+    m.def("_release_print_stream", &PrintRouter::release_stream,
+          nb::arg("stream"),
+          nb::arg("previous"),
+          R"pbdoc(
+            Stop sending unrouted `print()` output to `stream` (a logger whose `redirect_print` the
+            router replaced), falling back to `previous` or `sys.__stdout__`.
+          )pbdoc");
+
+    m.def("_pop_print_target", &PrintRouter::pop,
+          nb::arg("token"),
+          R"pbdoc(
+            Restore the print target that was active before the matching `_push_print_target`,
+            flushing the unbound target if anything was printed to it.
+          )pbdoc");
+
+    m.def("_push_context", [](const nb::dict &fields)
+          {
+              nb::object parent = LogContext::current();
+              auto *frame = new LogContext(LogContext::from(parent), fields);
+              nb::capsule owner(frame, [](void *p) noexcept
+                                { delete static_cast<LogContext *>(p); });
+              return LogContext::var().attr("set")(owner); },
+          nb::arg("fields"),
+          R"pbdoc(
+            Push a frame of contextual fields merged over the current ones and return the
+            `contextvars.Token` that `_pop_context` needs to restore the previous frame.
+          )pbdoc");
+
+    m.def("_pop_context", [](nb::handle token)
+          { LogContext::var().attr("reset")(token); },
+          nb::arg("token"),
+          R"pbdoc(
+            Restore the context frame that was active before the matching `_push_context`.
+          )pbdoc");
+
+    m.def("current_context", []()
+          {
+              nb::dict result;
+              nb::object context = LogContext::current();
+              if (const LogContext *frame = LogContext::from(context))
+                  for (const auto &[key, value] : frame->fields())
+                      result[key.c_str()] = value;
+              return result; },
+          R"pbdoc(
+            Return the contextual fields active in the calling thread or task as a dict of strings.
+          )pbdoc");
+
+    m.def("enable_level_control", [](bool signal, const std::string &control_file, double poll_interval, int signal_level,
+                                     int clear_signal)
+          {
+              nb::gil_scoped_release release;
+              LevelControl::start(signal, control_file, poll_interval, signal_level, clear_signal); },
+          nb::arg("signal") = true,
+          nb::arg("control_file") = "",
+          nb::arg("poll_interval") = 1.0,
+          nb::arg("signal_level") = 10,
+          nb::arg("clear_signal") = 0,
+          R"pbdoc(
+            Let the levels of all loggers be changed at runtime from outside the process.
+
+            Args:
+                signal (bool, optional): Toggle every logger between its own level and `signal_level`
+                    on each `SIGUSR2` (e.g. `kill -USR2 <pid>`). Not available on Windows. Defaults
+                    to True.
+                control_file (str, optional): File polled for level overrides, one `LEVEL` (all loggers)
+                    or `name=LEVEL` (loggers with that name) per line, e.g. `DEBUG` or `train=INFO`.
+                    Removing a line or the file restores the loggers' own levels. Defaults to "" (none).
+                poll_interval (float, optional): Seconds between checks of the control file. Defaults to 1.0.
+                signal_level (int, optional): The level `SIGUSR2` switches to. Defaults to 10 (DEBUG).
+                clear_signal (int, optional): Opt-in signal that lifts the override, e.g.
+                    `signal.SIGUSR1`; `SIGUSR2` then always sets it instead of toggling, so
+                    repeated signals cannot get out of step. Its previous handler is replaced until
+                    the control is disabled. Defaults to 0 (none: only `SIGUSR2` is handled).
+
+            A background thread applies changes by publishing new logger settings, so logging
+            itself still only compares the message level with an integer. Overrides do not touch
+            the loggers' own levels, so a `reconfigure(level=...)` made meanwhile takes effect once
+            the override is lifted. Calling it again replaces the previous setup.
+
+            Raises:
+                ValueError: If `signal` is requested on Windows, or `clear_signal` is given without
+                    `signal` or is not a catchable signal other than `SIGUSR2`.
+          )pbdoc");
+    m.def("disable_level_control", []
+          {
+              nb::gil_scoped_release release;
+              LevelControl::stop(); },
+          R"pbdoc(
+            Stop the runtime level control and restore every logger's own level.
+          )pbdoc");
+    nb::module_::import_("atexit").attr("register")(m.attr("disable_level_control"));
+    m.def("flush_all", []
+          {
+              nb::gil_scoped_release release;
+              LevelControl::flush_all(); },
+          R"pbdoc(
+            Flush the files and the console of every live logger before returning.
+          )pbdoc");
+    nb::module_::import_("atexit").attr("register")(m.attr("flush_all"));
+
+    m.def("configure_engine", &CppLogger::configure_engine,
+          nb::arg("queue_capacity") = 8192,
+          nb::arg("priority_capacity") = 1024,
+          nb::arg("drop_report_interval") = 1.0,
+          nb::arg("writer_threads") = 1,
+          nb::arg("cpu_affinity") = std::vector<int>(),
+          nb::arg("nice") = 0,
+          nb::arg("idle_priority") = false,
+          nb::arg("spin_us") = 0.0,
+          nb::arg("huge_pages") = "off",
+          R"pbdoc(
+            Configure the background writers used by loggers with a `latency_budget`.
+
+            Args:
+                queue_capacity (int, optional): Records a shard's queue holds before callers start
+                    waiting (up to their budget) and dropping. Rounded up to a power of two.
+                    Defaults to 8192.
+                priority_capacity (int, optional): Records a shard's priority lane (see
+                    `CppLogger.priority_level`) holds. Defaults to 1024.
+                drop_report_interval (float, optional): Minimum seconds between "N records dropped"
+                    lines. Defaults to 1.0.
+                writer_threads (int, optional): Size of the writer pool. Records are sharded by
+                    the logger's own file, two shards per thread, so the records of a logger (and
+                    of loggers sharing its file) keep their order; an idle thread steals shards
+                    from busy ones. With more than one thread, the console or a routed file shared
+                    by loggers with different files may receive their records out of order.
+                    Defaults to 1.
+                cpu_affinity (list[int], optional): CPUs the writer and level-control threads may
+                    run on, to keep them off the cores of pinned compute threads (Linux and
+                    Windows). Defaults to [] (any CPU).
+                nice (int, optional): Nice value of those threads, from -20 to 19. On macOS a
+                    positive value selects the utility QoS class. Defaults to 0.
+                idle_priority (bool, optional): Run those threads only on otherwise idle CPUs
+                    (`SCHED_IDLE` on Linux, the background QoS class on macOS, idle priority on
+                    Windows). Defaults to False.
+                spin_us (float, optional): Microseconds a writer thread keeps polling for records
+                    before parking. While it polls, producers hand records over without waking
+                    it, i.e. without a system call; 0 parks at once, which costs producers a
+                    wake-up only for the first record after a pause. Defaults to 0.
+                huge_pages (str, optional): Backing of the queue rings, which are mapped on the
+                    NUMA node of the first thread that logs into them: 'off', 'transparent'
+                    (advise transparent huge pages, Linux) or 'explicit' (reserved huge pages via
+                    `MAP_HUGETLB` or Windows large pages, falling back to 'transparent').
+                    Defaults to 'off'.
+
+            Raises:
+                ValueError: If a capacity or `writer_threads` is 0, a CPU index or `nice` is out of
+                    range, `spin_us` or `drop_report_interval` is negative or NaN, or `huge_pages`
+                    is unknown.
+                RuntimeError: If any setting but `drop_report_interval` changes after the writers
+                    started.
+          )pbdoc");
+
+    m.def("add_level", &LevelRegistry::add,
+          nb::arg("name"),
+          nb::arg("value"),
+          nb::arg("color") = "",
+          R"pbdoc(
+            Register a custom level name, or rename an existing level.
+
+            Args:
+                name (str): The name written in the level column, e.g. "TRACE".
+                value (int): The numeric level, between 1 and 255.
+                color (str, optional): Console color, e.g. "cyan", "bold red" or a raw ANSI escape
+                    sequence. Defaults to "" (no color).
+
+            Raises:
+                ValueError: If the value is out of range, the name contains '|' or control
+                    characters, or the color is unknown.
+          )pbdoc");
+    m.def("level_name", &LevelRegistry::name,
+          nb::arg("value"),
+          R"pbdoc(
+            Return the name of a level, or "Level N" if none was registered for it.
+          )pbdoc");
+    m.def("level_value", &LevelRegistry::value,
+          nb::arg("name"),
+          R"pbdoc(
+            Return the numeric value of a level name, or -1 if it is unknown.
+          )pbdoc");
+
+    m.def("_thread_renamed", &ThreadIdentity::invalidate,
+          R"pbdoc(
+            Invalidate the cached identity fields of every thread after a Python thread was renamed.
+          )pbdoc");
+
+    LogContext::init();
+    PrintRouter::init();
+    CallerLocation::set_module(m);
+    ThreadIdentity::init();
+    init_logscan(m);
+}
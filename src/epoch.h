@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Epoch-based reclamation (RCU) for objects that are read far more often than replaced
+ *
+ * Readers bracket their accesses with an `EpochGuard`, which announces the current epoch in a
+ * slot owned by the calling thread; entering and leaving a read section touches no shared
+ * cache line that other readers write. Writers publish the replacement first and then
+ * `retire()` the old object, which is destroyed once no thread that could still see it is
+ * inside a read section.
+ */
+class EpochDomain
+{
+public:
+    /**
+     * @brief The process-wide domain (never destroyed, so threads may still exit after module teardown)
+     */
+    static EpochDomain &instance()
+    {
+        static EpochDomain *domain = new EpochDomain();
+        return *domain;
+    }
+
+    /**
+     * @brief Schedule `deleter` to run once every reader that may still see the retired object has left
+     *
+     * Must be called after the object has been unpublished.
+     */
+    void retire(std::function<void()> deleter)
+    {
+        std::vector<std::function<void()>> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            retired_.emplace_back(epoch_.fetch_add(1), std::move(deleter));
+
+            uint64_t oldest = kIdle;
+            for (const auto &slot : slots_)
+                oldest = std::min(oldest, slot->epoch.load());
+            auto keep = retired_.begin();
+            for (auto it = retired_.begin(); it != retired_.end(); ++it)
+            {
+                if (it->first < oldest)
+                    ready.push_back(std::move(it->second));
+                else
+                    *keep++ = std::move(*it);
+            }
+            retired_.erase(keep, retired_.end());
+        }
+        for (auto &fn : ready)
+            fn(); // outside the lock: deleters may flush and close files
+    }
+
+private:
+    friend class EpochGuard;
+
+    static constexpr uint64_t kIdle = ~uint64_t(0);
+
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> epoch{kIdle}; // epoch announced by the owning thread, or kIdle
+        std::atomic<bool> in_use{false};
+        unsigned depth = 0; // nesting of read sections, touched by the owning thread only
+    };
+
+    /**
+     * @brief Registers a slot for the calling thread and releases it for reuse when the thread exits
+     */
+    struct ThreadSlot
+    {
+        Slot *slot;
+        explicit ThreadSlot(EpochDomain &domain) : slot(domain.acquire_slot()) {}
+        ~ThreadSlot()
+        {
+            slot->epoch.store(kIdle);
+            slot->in_use.store(false, std::memory_order_release);
+        }
+    };
+
+    Slot &slot()
+    {
+        thread_local ThreadSlot thread_slot(*this);
+        return *thread_slot.slot;
+    }
+
+    Slot *acquire_slot()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &slot : slots_)
+        {
+            bool expected = false;
+            if (slot->in_use.compare_exchange_strong(expected, true))
+                return slot.get();
+        }
+        slots_.push_back(std::make_unique<Slot>());
+        slots_.back()->in_use.store(true);
+        return slots_.back().get();
+    }
+
+    std::atomic<uint64_t> epoch_{0};
+    std::mutex mutex_;                                                // guards `slots_` and `retired_`
+    std::vector<std::unique_ptr<Slot>> slots_;                        // never shrinks, slots are reused
+    std::vector<std::pair<uint64_t, std::function<void()>>> retired_; // (epoch when retired, deleter)
+};
+
+/**
+ * @brief Read section of the `EpochDomain`: objects loaded inside it stay alive until it ends
+ *
+ * Sections nest; only the outermost one announces an epoch.
+ */
+class EpochGuard
+{
+public:
+    EpochGuard() : slot_(EpochDomain::instance().slot())
+    {
+        // Sequentially consistent, so a writer that retires an object after this announcement
+        // cannot miss it, and a pointer loaded afterwards is at least as new as the epoch
+        if (slot_.depth++ == 0)
+            slot_.epoch.store(EpochDomain::instance().epoch_.load());
+    }
+
+    ~EpochGuard()
+    {
+        if (--slot_.depth == 0)
+            slot_.epoch.store(EpochDomain::kIdle, std::memory_order_release);
+    }
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+
+private:
+    EpochDomain::Slot &slot_;
+};
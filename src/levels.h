@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "epoch.h"
+
+/**
+ * @brief Process-wide table of level names and console colors, indexed by level value
+ *
+ * Every value in [0, 255] owns a slot holding the header segment `" | NAME | "` already
+ * rendered, so formatting a record appends one string picked by index instead of searching
+ * a table. Values nobody registered render as `Level N`, like Python's `logging` does.
+ * Registration publishes a new table and retires the old one through the `EpochDomain`, so
+ * lookups must happen inside an `EpochGuard`.
+ */
+class LevelRegistry
+{
+public:
+    static constexpr int kSize = 256;
+
+    struct Level
+    {
+        std::string name;
+        std::string segment; // " | NAME | " as written between the logger name and the message
+        std::string color;   // ANSI escape sequence used on terminals, empty for none
+        bool registered = false;
+    };
+
+    struct Table
+    {
+        std::array<Level, kSize> levels;
+        std::vector<std::pair<std::string, int>> names; // registered names, for the reverse lookup
+    };
+
+    /**
+     * @brief The current table; the caller must hold an `EpochGuard` while using it
+     */
+    static const Table &table() { return *current().load(std::memory_order_acquire); }
+
+    /**
+     * @brief Append the `" | NAME | "` header segment of `level` to `out`
+     */
+    static void append_segment(std::string &out, int level)
+    {
+        if (level >= 0 && level < kSize)
+        {
+            out.append(table().levels[static_cast<size_t>(level)].segment);
+            return;
+        }
+        out.append(" | Level ");
+        out.append(std::to_string(level));
+        out.append(" | ");
+    }
+
+    /**
+     * @brief Name of `level` (`Level N` if it was never registered)
+     */
+    static std::string name(int level)
+    {
+        if (level < 0 || level >= kSize)
+            return "Level " + std::to_string(level);
+        EpochGuard guard;
+        return table().levels[static_cast<size_t>(level)].name;
+    }
+
+    /**
+     * @brief Value of a rendered level name, including `Level N` (-1 if unknown)
+     */
+    static int value(std::string_view name)
+    {
+        {
+            EpochGuard guard;
+            for (const auto &[registered, value] : table().names)
+            {
+                if (registered == name)
+                    return value;
+            }
+        }
+        constexpr std::string_view prefix = "Level ";
+        if (name.size() <= prefix.size() || name.substr(0, prefix.size()) != prefix)
+            return -1;
+        int value = 0;
+        for (char c : name.substr(prefix.size()))
+        {
+            if (c < '0' || c > '9' || value > 100000000)
+                return -1;
+            value = value * 10 + (c - '0');
+        }
+        return value;
+    }
+
+    /**
+     * @brief Register `name` for `value`, replacing any previous name of that value
+     *
+     * @param color A color name ("red", "bold yellow", ...), a raw ANSI escape sequence, or ""
+     * @throws std::invalid_argument for values outside [1, 255], names that would break the
+     *         line layout, and unknown colors
+     */
+    static void add(const std::string &name, int value, const std::string &color)
+    {
+        if (value < 1 || value >= kSize)
+            throw std::invalid_argument("level value must be between 1 and 255, got " + std::to_string(value));
+        if (name.empty())
+            throw std::invalid_argument("level name must not be empty");
+        for (unsigned char c : name)
+        {
+            if (c < 0x20 || c == '|' || c == 0x7f)
+                throw std::invalid_argument("level name must not contain '|' or control characters: " + name);
+        }
+        if (name.compare(0, 6, "Level ") == 0)
+            throw std::invalid_argument("level names starting with 'Level ' are reserved: " + name);
+        std::string escape = color_escape(color);
+
+        std::lock_guard<std::mutex> lock(mutex());
+        auto table = std::make_unique<Table>(LevelRegistry::table());
+        auto &names = table->names;
+        for (auto it = names.begin(); it != names.end();)
+            it = (it->first == name || it->second == value) ? names.erase(it) : it + 1;
+        for (auto &level : table->levels)
+        {
+            if (level.registered && level.name == name)
+                level = unregistered(static_cast<int>(&level - table->levels.data()));
+        }
+        names.emplace_back(name, value);
+        table->levels[static_cast<size_t>(value)] = registered(name, std::move(escape));
+
+        const Table *old = current().exchange(table.release(), std::memory_order_acq_rel);
+        EpochDomain::instance().retire([old] { delete old; });
+    }
+
+    /**
+     * @brief Translate a color name into its ANSI escape sequence
+     *
+     * Accepts the eight basic colors, optionally preceded by "bold" and/or "bright", or an
+     * escape sequence that is used verbatim.
+     */
+    static std::string color_escape(const std::string &color)
+    {
+        if (color.empty() || color[0] == '\x1b')
+            return color;
+        static constexpr std::string_view colors[] = {"black", "red",     "green", "yellow",
+                                                      "blue",  "magenta", "cyan",  "white"};
+        std::string_view rest = color;
+        bool bold = false, bright = false;
+        for (auto [word, flag] : {std::pair<std::string_view, bool *>{"bold ", &bold}, {"bright ", &bright}})
+        {
+            if (rest.substr(0, word.size()) == word)
+            {
+                *flag = true;
+                rest.remove_prefix(word.size());
+            }
+        }
+        for (size_t i = 0; i < std::size(colors); ++i)
+        {
+            if (colors[i] == rest)
+                return std::string(bold ? "\033[1;" : "\033[") + std::to_string((bright ? 90 : 30) + i) + "m";
+        }
+        throw std::invalid_argument("unknown color '" + color + "'");
+    }
+
+private:
+    static Level registered(const std::string &name, std::string color)
+    {
+        return Level{name, " | " + name + " | ", std::move(color), true};
+    }
+
+    static Level unregistered(int value)
+    {
+        std::string name = "Level " + std::to_string(value);
+        return Level{name, " | " + name + " | ", "", false};
+    }
+
+    static const Table *make_default()
+    {
+        auto table = new Table();
+        for (int value = 0; value < kSize; ++value)
+            table->levels[static_cast<size_t>(value)] = unregistered(value);
+        static const std::pair<int, const char *> builtin[] = {
+            {0, "NOTSET"}, {10, "DEBUG"}, {20, "INFO"}, {30, "WARNING"}, {40, "ERROR"}, {50, "CRITICAL"}};
+        static const char *const colors[] = {"", "\033[36m", "\033[32m", "\033[33m", "\033[31m", "\033[1;31m"};
+        for (size_t i = 0; i < std::size(builtin); ++i)
+        {
+            table->levels[static_cast<size_t>(builtin[i].first)] = registered(builtin[i].second, colors[i]);
+            table->names.emplace_back(builtin[i].second, builtin[i].first);
+        }
+        return table;
+    }
+
+    // Both leaked, like the `EpochDomain`, so native threads may log during interpreter teardown
+    static std::atomic<const Table *> &current()
+    {
+        static auto *table = new std::atomic<const Table *>(make_default());
+        return *table;
+    }
+
+    static std::mutex &mutex()
+    {
+        static auto *mutex = new std::mutex();
+        return *mutex;
+    }
+};
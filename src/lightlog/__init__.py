@@ -1,8 +1,14 @@
+from .cpplightlog import (configure_engine, current_context, disable_level_control, enable_level_control,
+                          flush_all)
 from .decorator import log_prints
-from .levelsvalue import CRITICAL, DEBUG, ERROR, INFO, NOTSET, WARNING
-from .pylightlog import Logger
+from .levelsvalue import CRITICAL, DEBUG, ERROR, INFO, NOTSET, WARNING, add_level, get_level_name, get_level_value
+from .logtools import SeriesExtractor, extract_series, load_columns, read_scalars, scan_logs
+from .pylightlog import Logger, context
 
 __author__ = "Misagh Soltani"
 __email__ = "msoltani@email.sc.edu"
 __version__ = "0.1.0"
-__all__ = ["Logger", "log_prints", "DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL", "NOTSET"]
+__all__ = ["Logger", "log_prints", "context", "current_context", "enable_level_control",
+           "disable_level_control", "flush_all", "configure_engine", "scan_logs", "load_columns",
+           "extract_series", "SeriesExtractor", "read_scalars", "DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL", "NOTSET",
+           "add_level", "get_level_name", "get_level_value"]
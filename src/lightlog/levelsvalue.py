@@ -1,6 +1,51 @@
+from .cpplightlog import add_level as _add_level
+from .cpplightlog import level_name as _level_name
+from .cpplightlog import level_value as _level_value
+
 NOTSET = 0
 DEBUG = 10
 INFO = 20
 WARNING = 30
 ERROR = 40
 CRITICAL = 50
+
+
+def add_level(name: str, value: int, color: str = '') -> int:
+    """
+    Registers a custom level, or renames an existing one, for every logger in the process.
+
+    Level names live in a native table indexed by value, so a custom level costs nothing
+    more to render than a built-in one. Values that were never registered are written as
+    'Level N'.
+
+    Args:
+        name (str): The name written in the level column, e.g. 'TRACE'. Must not contain '|'.
+        value (int): The numeric level, between 1 and 255.
+        color (str): Console color, e.g. 'cyan', 'bold red', 'bright magenta', or a raw ANSI
+            escape sequence. Default is '' (no color).
+
+    Returns:
+        int: `value`, so the call can define a constant.
+
+    Example:
+        >>> from lightlog import Logger, add_level
+        >>> TRACE = add_level('TRACE', 5, color='bright black')
+        >>> logger = Logger('train', level=TRACE)
+        >>> logger.log('entering step', level=TRACE)
+    """
+    _add_level(name, value, color)
+    return value
+
+
+def get_level_name(value: int) -> str:
+    """
+    Returns the name a level is written with, e.g. 'WARNING' for 30 or 'Level 25' for 25.
+    """
+    return _level_name(value)
+
+
+def get_level_value(name: str) -> int:
+    """
+    Returns the numeric value of a level name, or -1 if no level has that name.
+    """
+    return _level_value(name)
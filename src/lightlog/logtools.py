@@ -0,0 +1,218 @@
+import argparse
+import glob
+from datetime import datetime
+from os import path as os_path
+from typing import Any, Dict, Iterable, List, Optional, Tuple, Union
+
+from . import cpplightlog
+from .cpplightlog import CppSeriesExtractor
+
+PathsLike = Union[str, Iterable[str]]
+TimeLike = Union[str, datetime, None]
+
+
+def _expand_paths(paths: PathsLike) -> List[str]:
+    """
+    Expands a path, a glob pattern, or an iterable of those into a list of absolute file paths.
+    """
+    if isinstance(paths, str):
+        paths = [paths]
+    expanded = []
+    for entry in paths:
+        matches = sorted(glob.glob(entry)) if any(c in entry for c in '*?[') else [entry]
+        expanded.extend(os_path.abspath(match) for match in matches)
+    return expanded
+
+
+def _format_time(value: TimeLike) -> str:
+    """
+    Converts a time bound to the `YYYY-mm-dd HH:MM:SS,mmm` layout used in log files.
+    """
+    if value is None:
+        return ''
+    if isinstance(value, datetime):
+        return value.strftime('%Y-%m-%d %H:%M:%S,') + f'{value.microsecond // 1000:03d}'
+    return value
+
+
+def scan_logs(paths: PathsLike,
+              pattern: str = '',
+              level: Optional[int] = None,
+              rank: Optional[int] = None,
+              name: Optional[str] = None,
+              since: TimeLike = None,
+              until: TimeLike = None,
+              threads: int = 0) -> List[Tuple[int, str, str]]:
+    """
+    Searches log files written by `Logger` and returns the matching lines in timestamp order.
+
+    The files are memory-mapped and scanned by a pool of native threads, so scanning
+    hundreds of per-rank log files is bound by disk bandwidth rather than by Python.
+
+    Args:
+        paths (str | Iterable[str]): A file path, a glob pattern (e.g. 'logs/rank_*.log'), or
+            an iterable of those.
+        pattern (str): Substring that must appear in the line. Default is '' (any line).
+        level (Optional[int]): Minimum log level, e.g. `lightlog.WARNING`. Default is None.
+        rank (Optional[int]): Only return lines carrying this `[rank/world_size]` prefix.
+            Default is None.
+        name (Optional[str]): Only return lines written by the logger with this name.
+            Default is None.
+        since (str | datetime | None): Earliest timestamp to return. Default is None.
+        until (str | datetime | None): Latest timestamp to return. Default is None.
+        threads (int): Number of worker threads. Default is 0 (one per core).
+
+    Returns:
+        List[Tuple[int, str, str]]: `(timestamp_ms, path, line)` tuples sorted by timestamp.
+
+    Example:
+        >>> from lightlog import ERROR, scan_logs
+        >>> for ts, path, line in scan_logs('logs/*.log', 'CUDA', level=ERROR):
+        ...     print(path, line)
+    """
+    return cpplightlog.scan_logs(_expand_paths(paths), pattern,
+                                 -1 if level is None else level,
+                                 -1 if rank is None else rank, name or '', _format_time(since),
+                                 _format_time(until), threads)
+
+
+def load_columns(paths: PathsLike, threads: int = 0) -> Dict[str, Any]:
+    """
+    Parses log files into NumPy column arrays without creating per-line Python objects.
+
+    Every physical line becomes one row. Lines written without a header (e.g. at `NOTSET` or
+    through `print()` redirection) hold -1 in the header columns.
+
+    Args:
+        paths (str | Iterable[str]): A file path, a glob pattern, or an iterable of those.
+        threads (int): Number of worker threads. Default is 0 (one per core).
+
+    Returns:
+        Dict[str, Any]: The columns `timestamp` (int64 milliseconds), `level` (int16), `rank` and
+        `world_size` (int32), `name` (int32 codes into the `names` list), `file` (int32 codes into
+        the `paths` list), and the messages as `message_offsets` (int64, one longer than the other
+        columns) into the shared `message_buffer` (uint8).
+
+    Example:
+        >>> import pandas as pd
+        >>> from lightlog import load_columns
+        >>> cols = load_columns('logs/*.log')
+        >>> df = pd.DataFrame({
+        ...     'time': pd.to_datetime(cols['timestamp'], unit='ms'),
+        ...     'level': cols['level'],
+        ...     'rank': cols['rank'],
+        ...     'name': pd.Categorical.from_codes(cols['name'], cols['names']),
+        ... })
+        >>> buf, off = cols['message_buffer'], cols['message_offsets']
+        >>> first_message = buf[off[0]:off[1]].tobytes().decode()
+    """
+    return cpplightlog.load_columns(_expand_paths(paths), threads)
+
+
+def read_scalars(path: str) -> Dict[str, Tuple[Any, Any, Any]]:
+    """
+    Loads a binary series file written by `Logger.log_scalar` / `Logger.log_scalars`.
+
+    Args:
+        path (str): Path of the series file (by default the log file path plus '.metrics').
+
+    Returns:
+        Dict[str, Tuple[Any, Any, Any]]: `{name: (steps, values, timestamps)}` with int64 steps,
+        float64 values and int64 timestamps in nanoseconds since the epoch.
+
+    Example:
+        >>> logger = Logger('train', 'train.log')
+        >>> logger.log_scalars({'loss': 0.31, 'lr': 3e-4}, step=1200)
+        >>> logger.flush()
+        >>> steps, loss, _ = read_scalars('train.log.metrics')['loss']
+    """
+    return cpplightlog.read_scalars(os_path.abspath(path))
+
+
+class SeriesExtractor(CppSeriesExtractor):
+    """
+    Pulls numeric time series out of log files, incrementally.
+
+    Fields written as `key value`, `key=value` or `key: value` (e.g. `step 1200 loss 0.31
+    lr 3e-4`) are parsed natively into contiguous float64 arrays keyed by field name, with
+    the step taken from the most recent `step_key` field of the same file. Each call to
+    `update()` only parses the lines appended since the previous call, so the extractor can
+    follow the file a `Logger` is still writing to.
+
+    Example:
+        >>> extractor = SeriesExtractor(keys=['loss', 'lr'])
+        >>> extractor.update('train.log')
+        >>> steps, loss = extractor.series()['loss']
+    """
+
+    def __init__(self, keys: Optional[Iterable[str]] = None, step_key: str = 'step') -> None:
+        """
+        Args:
+            keys (Optional[Iterable[str]]): Field names to extract. Default is None (every
+                numeric field).
+            step_key (str): Name of the field holding the step. Default is 'step'.
+        """
+        super().__init__(list(keys or []), step_key)
+
+    def update(self, paths: PathsLike, threads: int = 0) -> int:
+        """
+        Parses the complete lines appended to the given files since the last call.
+
+        Args:
+            paths (str | Iterable[str]): A file path, a glob pattern, or an iterable of those.
+            threads (int): Number of worker threads. Default is 0 (one per core).
+
+        Returns:
+            int: The number of samples added.
+        """
+        return super().update(_expand_paths(paths), threads)
+
+
+def extract_series(paths: PathsLike,
+                   keys: Optional[Iterable[str]] = None,
+                   step_key: str = 'step',
+                   threads: int = 0) -> Dict[str, Tuple[Any, Any]]:
+    """
+    Extracts numeric time series from log files in one pass.
+
+    Args:
+        paths (str | Iterable[str]): A file path, a glob pattern, or an iterable of those.
+        keys (Optional[Iterable[str]]): Field names to extract. Default is None (every numeric
+            field).
+        step_key (str): Name of the field holding the step. Default is 'step'.
+        threads (int): Number of worker threads. Default is 0 (one per core).
+
+    Returns:
+        Dict[str, Tuple[Any, Any]]: `{name: (steps, values)}` with int64 steps and float64 values.
+
+    Example:
+        >>> from lightlog import extract_series
+        >>> steps, loss = extract_series('train.log', keys=['loss'])['loss']
+    """
+    extractor = SeriesExtractor(keys, step_key)
+    extractor.update(paths, threads)
+    return extractor.series()
+
+
+def _main(argv: Optional[List[str]] = None) -> None:
+    parser = argparse.ArgumentParser(
+        prog='python -m lightlog.logtools',
+        description='Search LightLog files in parallel and print matches in timestamp order.')
+    parser.add_argument('pattern', help="substring to search for ('' matches every line)")
+    parser.add_argument('paths', nargs='+', help='log files or glob patterns')
+    parser.add_argument('--level', type=int, default=None, help='minimum numeric log level')
+    parser.add_argument('--rank', type=int, default=None, help='only lines from this rank')
+    parser.add_argument('--name', default=None, help='only lines from this logger name')
+    parser.add_argument('--since', default=None, help="earliest time, 'YYYY-mm-dd HH:MM:SS'")
+    parser.add_argument('--until', default=None, help="latest time, 'YYYY-mm-dd HH:MM:SS'")
+    parser.add_argument('--threads', type=int, default=0, help='worker threads (0 = all cores)')
+    parser.add_argument('-H', '--with-filename', action='store_true', help='prefix lines with their file')
+    args = parser.parse_args(argv)
+
+    for _, file_path, line in scan_logs(args.paths, args.pattern, args.level, args.rank, args.name,
+                                        args.since, args.until, args.threads):
+        print(f'{file_path}:{line}' if args.with_filename else line)
+
+
+if __name__ == '__main__':
+    _main()
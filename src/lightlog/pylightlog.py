@@ -1,9 +1,62 @@
 import sys
+import threading
+import warnings
+from contextlib import contextmanager
 from os import path as os_path
-from typing import Optional
+from typing import Dict, Iterable, Iterator, Optional, Tuple, Union
 
-from .cpplightlog import CppLogger
-from .levelsvalue import CRITICAL, DEBUG, ERROR, INFO, NOTSET, WARNING
+from .cpplightlog import (CppLogger, _pop_context, _pop_print_target, _push_context, _push_print_target,
+                          _release_print_stream, _thread_renamed, flush_all)
+from .levelsvalue import CRITICAL, ERROR, NOTSET
+
+SinksLike = Dict[str, Union[int, Tuple[int, int]]]
+_MAX_LEVEL = 2**31 - 1
+
+# Hooks replaced by `Logger.capture_warnings` / `Logger.install_excepthook`, restored on release
+_original_hooks = {}
+
+
+@contextmanager
+def context(**fields: object) -> Iterator[None]:
+    """
+    Adds contextual fields to every formatted log line written inside the block.
+
+    The fields are merged over any enclosing context and are stored in a `contextvars`
+    variable, so each thread and asyncio task sees only its own context. The field prefix is
+    rendered once when the block is entered; logging inside the block only copies it.
+    Lines written at `NOTSET` (e.g. redirected `print()` output) are left untouched.
+
+    Args:
+        **fields (object): Field names and values; values are converted with `str()`.
+
+    Example:
+        >>> with lightlog.context(epoch=3):
+        ...     with lightlog.context(step=1200):
+        ...         logger.info("loss went down")
+        2024-09-18 04:17:23,997 | train | INFO | epoch=3 step=1200 | loss went down
+    """
+    token = _push_context(fields)
+    try:
+        yield
+    finally:
+        _pop_context(token)
+
+
+def _track_thread_renames() -> None:
+    """
+    Wraps the `threading.Thread.name` setter so renaming a thread invalidates the cached
+    `thread=` identity field. Installed once, the first time a logger enables that field.
+    """
+    name_property = threading.Thread.name
+    if getattr(name_property.fset, '_lightlog_hook', False):
+        return
+
+    def set_name(thread: threading.Thread, value: str) -> None:
+        name_property.fset(thread, value)
+        _thread_renamed()
+
+    set_name._lightlog_hook = True
+    threading.Thread.name = property(name_property.fget, set_name, name_property.fdel, name_property.__doc__)
 
 
 class Logger(CppLogger):
@@ -30,10 +83,27 @@ class Logger(CppLogger):
                                     logging. Defaults to -1.
         auto_detect_env (Optional[str]): The environment auto-detection setting for rank
                                          information. Default is 'all'.
+        capture_location (bool): Whether formatted lines include the caller's
+                                 `file:line:function`. Default is `False`.
+        identity_fields (str): Comma-separated identity fields (`pid`, `tid`, `thread`)
+                               added to formatted lines. Default is ''.
+        multiline (str): How messages spanning several lines are prefixed: 'first',
+                         'prefix' or 'indent'. Default is 'first'.
+        color (str): Console coloring by level: 'auto', 'always' or 'never'. Default is
+                     'auto'.
+        latency_budget (float): Microseconds a logging call may spend handing its record to
+                                the background writer; 0 writes synchronously. Default is 0.
+        priority_level (int): Lowest level of queued records that bypass the backlog; 0
+                              disables the priority lane. Default is 0.
+        dropped (int): Records dropped because the latency budget was exceeded.
+        sinks (List[Tuple[str, int, int]]): Level-routed sinks as `(target, min_level,
+                                            max_level)`, where the target is 'console' or
+                                            an additional file.
         original_stdout (TextIO): A reference to the original `sys.stdout`, used to restore
                                   standard output after `print()` redirection.
-        _buffer (str): An internal buffer for storing partial log messages, allowing
-                       line-based logging.
+        _buffers (Dict[int, str]): Per-thread buffers for partial log messages, allowing
+                                   line-based logging without mixing the partial lines of
+                                   concurrent threads.
 
     Methods:
         __init__: Initializes the logger with the specified settings, including file
@@ -43,7 +113,7 @@ class Logger(CppLogger):
         write: Writes messages to the log, with optional arguments for including rank and
                specifying a new file path.
         flush: Flushes any buffered log messages.
-        log: Logs messages with variable arguments,.
+        log: Logs messages with variable arguments, joined like `print()`.
         info: Logs a message at the INFO level.
         debug: Logs a message at the DEBUG level.
         warning: Logs a message at the WARNING level.
@@ -54,6 +124,10 @@ class Logger(CppLogger):
             the logger.
         reset_print: Restores the `print()` function to its original behavior.
 
+    `log`, `debug`, `info`, `warning`, `error` and `critical` are implemented natively on
+    `CppLogger` (argument joining, level filtering and path handling happen in C++), so a call
+    costs a single vectorcall into the extension and no Python frames.
+
     Example:
         >>> from lightlog import Logger
         >>> from logging import WARNING
@@ -108,7 +182,14 @@ class Logger(CppLogger):
                  rank: Optional[int] = None,
                  world_size: Optional[int] = None,
                  auto_detect_env: Optional[str] = None,
-                 log_rank: Optional[int] = None) -> None:
+                 log_rank: Optional[int] = None,
+                 capture_location: bool = False,
+                 identity_fields: Optional[Iterable[str]] = None,
+                 multiline: str = 'first',
+                 sinks: Optional[SinksLike] = None,
+                 color: str = 'auto',
+                 latency_budget: float = 0.0,
+                 priority_level: int = NOTSET) -> None:
         """
         Initializes the Logger instance, setting up logging parameters and configuring
         the output destination.
@@ -136,9 +217,46 @@ class Logger(CppLogger):
                                              or the general case of using `RANK` and `WORLD_SIZE`.
             log_rank (Optional[int]): The rank of the process on which to log/print. Default
                                       is `None`.
+            capture_location (bool, optional): If `True`, formatted lines include the caller's
+                                               location as `file:line:function`. Default is
+                                               `False`.
+            identity_fields (Optional[Iterable[str]]): Identity fields added to formatted lines,
+                                               any of 'pid', 'tid' (OS thread id) and 'thread'
+                                               (Python thread name), e.g. `('pid', 'thread')`.
+                                               They are rendered once per thread and cached.
+                                               Default is `None` (no fields).
+            multiline (str, optional): How messages containing newlines are prefixed: 'first'
+                                       (first line only), 'prefix' (full prefix on every line,
+                                       so each line can be grepped and merged on its own) or
+                                       'indent' (continuation lines indented under the message).
+                                       Default is 'first'.
+            sinks (Optional[Dict[str, int | Tuple[int, int]]]): Routes records by level to the
+                                       console and to files besides `file_path`, mapping
+                                       'console' or a file path to a minimum level or a
+                                       `(min_level, max_level)` range, e.g.
+                                       `{'console': INFO, 'errors.log': WARNING}`. Each
+                                       record is formatted once and the same text goes to
+                                       every matching sink. The console receives every level
+                                       unless it is listed. Default is `None`.
+            color (str, optional): Colors console lines by level with the colors of the level
+                                   table: 'auto' (only when stdout is a terminal and `NO_COLOR`
+                                   is unset, checked once here), 'always' or 'never'. Files never
+                                   receive escape sequences. Default is 'auto'.
+            latency_budget (float, optional): Bounds the time a logging call may block, in
+                                   microseconds. When positive, records are formatted in the
+                                   caller and queued for a background writer thread; a record
+                                   that cannot be queued within the budget is dropped and
+                                   counted in `dropped`, and a "N records dropped" WARNING line
+                                   follows once the queue drains. Default is 0 (synchronous).
+            priority_level (int, optional): With a latency budget, records at or above this level
+                                   (e.g. `ERROR`) take a separate lane that the writer empties
+                                   first and flushes immediately. Lines then carry a `seq=N`
+                                   field for restoring the logging order offline. Default is
+                                   `NOTSET` (no priority lane).
 
         Raises:
-            ValueError: Raised if an invalid file mode is provided.
+            ValueError: Raised if an invalid file mode, identity field, multiline mode, sink or
+                        color mode is provided.
             IOError: Raised if the file specified by `file_path` cannot be opened for writing.
 
         Example:
@@ -153,12 +271,25 @@ class Logger(CppLogger):
         self.rank = rank or -1
         self.world_size = world_size or -1
         self.auto_detect_env = auto_detect_env or 'all'
-        self._buffer = ""  # Buffer for handling incomplete log messages
+        self._buffers = {}  # Per-thread buffers for handling incomplete log messages
+        self._print_tokens = threading.local()  # Per-thread stack of `with logger:` bindings
         self.log_rank = log_rank or -1
 
         # Call the base CppLogger constructor
         super().__init__(name, self.file_path, self.mode, self.level, self.use_rank, self.rank,
                          self.world_size, self.auto_detect_env, self.log_rank)
+        self.capture_location = capture_location
+        self.multiline = multiline
+        if identity_fields is not None:
+            self._set_identity_fields(identity_fields)
+        if sinks is not None:
+            self._set_sinks(sinks)
+        if color != 'auto':
+            self.color = color
+        if latency_budget:
+            self.latency_budget = latency_budget
+        if priority_level:
+            self.priority_level = priority_level
 
     def __del__(self) -> None:
         """
@@ -205,27 +336,29 @@ class Logger(CppLogger):
             >>> logger.write("Starting the process...", level=logging.DEBUG)
 
         Behavior:
-            - In case the message is split into multiple lines, each line will be logged
-            separately, and only the last incomplete line (if any) will remain in the buffer.
+            - In case the message contains multiple lines, every complete line is logged with
+            its own prefix (in a single native call), and only the last incomplete line (if
+            any) will remain in the buffer.
             - The `level` and `use_rank` parameters can be customized for each `write()` call.
 
         Warning:
             - Make sure to `flush()` the logger to ensure all buffered messages are written
             before terminating the application or closing the logger.
         """
-        self._buffer += message
-
-        # Split the buffer into lines, leaving incomplete lines in the buffer
-        lines = self._buffer.splitlines(keepends=True)
-        if not self._buffer.endswith('\n'):
-            self._buffer = lines.pop()  # Keep incomplete line in buffer
-        else:
-            self._buffer = ""
-
-        # Write each complete line to the log
-        for line in lines:
-            new_file_path = os_path.abspath(new_file_path) if new_file_path else ''
-            super().log(line, level, self.use_rank or use_rank, new_file_path)
+        # Each thread owns its buffer entry, so concurrent writers (also without the GIL) never
+        # mix their partial lines; dict operations on distinct keys are atomic
+        thread_id = threading.get_ident()
+        buffer = self._buffers.pop(thread_id, '') + message
+
+        # Hand all complete lines to the core in one call, leaving the incomplete line in the buffer
+        cut = buffer.rfind('\n') + 1
+        if cut < len(buffer):
+            self._buffers[thread_id] = buffer[cut:]
+        if not cut:
+            return
+        lines = buffer[:cut]
+        new_file_path = os_path.abspath(new_file_path) if new_file_path else ''
+        self.log_lines(lines, level, self.use_rank or use_rank, new_file_path)
 
     def flush(self) -> None:
         """
@@ -249,54 +382,12 @@ class Logger(CppLogger):
             immediately, even if it does not end with a newline character.
             - After flushing, the buffer is reset and the logger state is updated.
         """
-        if self._buffer:  # If buffer is not empty
-            super().log(self._buffer, level=-1, use_rank=self.use_rank)
-            self._buffer = ""
+        for thread_id in list(self._buffers):
+            buffer = self._buffers.pop(thread_id, '')
+            if buffer:  # If buffer is not empty
+                self.log_message(buffer, level=-1, use_rank=self.use_rank)
         super().flush()
 
-    def log(self,
-            *args: object,
-            sep: Optional[str] = " ",
-            end: Optional[str] = "\n",
-            level: int = NOTSET,
-            use_rank: bool = False,
-            new_file_path: str = None) -> None:
-        """
-        Logs a formatted message by joining multiple arguments.
-
-        This method allows for logging arbitrary numbers of arguments by converting
-        them into strings, joining them with the specified separator (`sep`), and
-        appending the specified ending (`end`). The resulting message is passed
-        to the logger's C++ core with optional log level, rank, and file path settings.
-
-        Args:
-            *args (object): The components of the message to be logged. Each argument
-                            will be converted to a string and joined using the specified
-                            `sep`.
-            sep (str, optional): Separator used to join the arguments. Defaults to a space `" "`.
-            end (str, optional): String appended after the joined message. Defaults to a
-                newline `"\n"`.
-            level (int, optional): The log level for the message. Defaults to NOTSET
-            use_rank (bool, optional): If `True`, includes rank information. Defaults to `False`.
-            new_file_path (str, optional): If provided, logs the message to a different file than
-                                        the one specified when initializing the logger. Defaults to
-                                        None.
-
-        Example:
-            >>> logger.log("Initializing module:", "ModuleA", sep=" ", end=".\n")
-            >>> logger.log("Value:", 42, "Threshold:", 100, sep=", ")
-
-        Behavior:
-            - Converts all arguments to strings, joins them with the specified separator (`sep`),
-            and appends the string `end`.
-            - The `level` and `use_rank` can be specified dynamically for each call, allowing
-            flexibility in logging different levels of messages in different contexts.
-            - Supports redirection to a new file via `new_file_path` if needed.
-        """
-        message = sep.join(map(str, args)) + end
-        new_file_path = os_path.abspath(new_file_path) if new_file_path else ''
-        super().log(message, level, self.use_rank or use_rank, new_file_path)
-
     def reconfigure(self,
                     name: str = None,
                     new_file_path: Optional[str] = None,
@@ -306,7 +397,14 @@ class Logger(CppLogger):
                     rank: Optional[int] = None,
                     world_size: Optional[int] = None,
                     auto_detect_env: Optional[str] = None,
-                    log_rank: Optional[int] = None) -> None:
+                    log_rank: Optional[int] = None,
+                    capture_location: Optional[bool] = None,
+                    identity_fields: Optional[Iterable[str]] = None,
+                    multiline: Optional[str] = None,
+                    sinks: Optional[SinksLike] = None,
+                    color: Optional[str] = None,
+                    latency_budget: Optional[float] = None,
+                    priority_level: Optional[int] = None) -> None:
         """
         Reconfigures the logger with new settings, updating all relevant parameters.
 
@@ -329,9 +427,25 @@ class Logger(CppLogger):
                 for rank-based logging. Defaults to None.
             log_rank (Optional[int]): The rank of the process on which to log/print. Defaults
                 to None.
+            capture_location (Optional[bool]): If given, enables or disables the caller location
+                field. Defaults to None.
+            identity_fields (Optional[Iterable[str]]): If given, replaces the identity fields
+                ('pid', 'tid', 'thread'); pass `()` to remove them. Defaults to None.
+            multiline (Optional[str]): If given, sets how messages spanning several lines are
+                prefixed ('first', 'prefix' or 'indent'). Defaults to None.
+            sinks (Optional[Dict[str, int | Tuple[int, int]]]): If given, replaces the
+                level-routed sinks; files that stay routed are kept open. Pass `{}` to remove
+                them. Defaults to None.
+            color (Optional[str]): If given, sets console coloring ('auto', 'always' or 'never')
+                and repeats the terminal check. Defaults to None.
+            latency_budget (Optional[float]): If given, sets the latency budget in microseconds
+                (0 for synchronous writes). Defaults to None.
+            priority_level (Optional[int]): If given, sets the lowest level that takes the
+                priority lane (0 disables it). Defaults to None.
 
         Raises:
-            ValueError: If an invalid file mode is provided.
+            ValueError: If an invalid file mode, identity field, multiline mode, sink or color mode
+                is provided.
             IOError: If the file specified by new_file_path cannot be opened for writing.
 
         Examples:
@@ -352,147 +466,177 @@ class Logger(CppLogger):
         # Call the base CppLogger constructor
         super().reconfigure(self.name, self.file_path, self.mode, self.level, self.use_rank,
                             self.rank, self.world_size, self.auto_detect_env, self.log_rank)
-
-    def info(self,
-             *args: object,
-             sep: Optional[str] = " ",
-             end: Optional[str] = "\n",
-             use_rank: bool = False,
-             new_file_path: str = None) -> None:
-        """
-        Logs an INFO level message.
+        if capture_location is not None:
+            self.capture_location = capture_location
+        if identity_fields is not None:
+            self._set_identity_fields(identity_fields)
+        if multiline is not None:
+            self.multiline = multiline
+        if sinks is not None:
+            self._set_sinks(sinks)
+        if color is not None:
+            self.color = color
+        if latency_budget is not None:
+            self.latency_budget = latency_budget
+        if priority_level is not None:
+            self.priority_level = priority_level
+
+    def _set_identity_fields(self, identity_fields: Iterable[str]) -> None:
+        """
+        Applies the identity fields and hooks thread renames if the thread name is among them.
+        """
+        if isinstance(identity_fields, str):
+            identity_fields = [identity_fields]
+        fields = list(identity_fields)
+        self.identity_fields = ','.join(fields)
+        if 'thread' in fields:
+            _track_thread_renames()
+
+    def _set_sinks(self, sinks: SinksLike) -> None:
+        """
+        Converts `{target: level or (min_level, max_level)}` into the native sink list.
+        """
+        routes = []
+        for target, levels in sinks.items():
+            min_level, max_level = (levels, _MAX_LEVEL) if isinstance(levels, int) else levels
+            routes.append((target if target == 'console' else os_path.abspath(target), min_level,
+                           max_level))
+        self.sinks = routes
+
+    def exception(self,
+                  *args: object,
+                  sep: Optional[str] = " ",
+                  end: Optional[str] = "\n",
+                  exc_info: Optional[BaseException] = None,
+                  level: int = ERROR,
+                  use_rank: bool = False,
+                  new_file_path: str = None) -> None:
+        """
+        Logs a message followed by an exception and its traceback, by default at ERROR level.
+
+        The traceback is rendered natively in the layout of `traceback.print_exception` (without
+        the source lines), including chained exceptions, and the whole block is written as one
+        record, so it cannot interleave with lines logged from other threads.
 
         Args:
             *args: The message components to be joined and logged.
             sep: Optional; Separator used to join the components. Default is a space.
             end: Optional; String appended after the message. Default is newline.
+            exc_info: Optional; The exception to log. Default is None (the exception currently
+                being handled; if there is none, only the message is logged).
+            level: Optional; The log level of the record. Default is ERROR.
             use_rank: Optional; If True, include rank information. Default is False.
             new_file_path: Optional; Write to a new log file if provided.
 
         Example:
-            >>> logger.info("This is an info message.")
+            >>> try:
+            ...     1 / 0
+            ... except ZeroDivisionError:
+            ...     logger.exception("Evaluation failed")
+            2024-09-18 04:17:23,997 | train | ERROR | Evaluation failed
+            Traceback (most recent call last):
+              File "/home/user/train.py", line 2, in <module>
+            ZeroDivisionError: division by zero
         """
+        message = sep.join(map(str, args)) + end
         new_file_path = os_path.abspath(new_file_path) if new_file_path else ''
-        self.log(*args,
-                 sep=sep,
-                 end=end,
-                 level=INFO,
-                 use_rank=use_rank,
-                 new_file_path=new_file_path)
-
-    def debug(self,
-              *args: object,
-              sep: Optional[str] = " ",
-              end: Optional[str] = "\n",
-              use_rank: bool = False,
-              new_file_path: str = None) -> None:
-        """
-        Logs a DEBUG level message.
-
-        Args:
-            *args: The message components to be joined and logged.
-            sep: Optional; Separator used to join the components. Default is a space.
-            end: Optional; String appended after the message. Default is newline.
-            use_rank: Optional; If True, include rank information. Default is False.
-            new_file_path: Optional; Write to a new log file if provided.
+        self.log_exception(message, level, exc_info, self.use_rank or use_rank, new_file_path)
 
-        Example:
-            >>> logger.debug("This is a debug message.")
+    def context(self, **fields: object):
         """
-        new_file_path = os_path.abspath(new_file_path) if new_file_path else ''
-        self.log(*args,
-                 sep=sep,
-                 end=end,
-                 level=DEBUG,
-                 use_rank=use_rank,
-                 new_file_path=new_file_path)
-
-    def warning(self,
-                *args: object,
-                sep: Optional[str] = " ",
-                end: Optional[str] = "\n",
-                use_rank: bool = False,
-                new_file_path: str = None) -> None:
-        """
-        Logs a WARNING level message.
+        Adds contextual fields to every formatted log line written inside the block.
 
-        Args:
-            *args: The message components to be joined and logged.
-            sep: Optional; Separator used to join the components. Default is a space.
-            end: Optional; String appended after the message. Default is newline.
-            use_rank: Optional; If True, include rank information. Default is False.
-            new_file_path: Optional; Write to a new log file if provided.
+        This is the same as the module-level `lightlog.context()`: the fields apply to all
+        loggers used in the current thread or task, which keeps lines from different loggers
+        of one request or training step correlated.
 
+        Args:
+            **fields (object): Field names and values; values are converted with `str()`.
 
         Example:
-            >>> logger.warning("This is a warning message.")
+            >>> with logger.context(epoch=3, step=1200):
+            ...     logger.info("checkpoint saved")
+            2024-09-18 04:17:23,997 | train | INFO | epoch=3 step=1200 | checkpoint saved
         """
+        return context(**fields)
 
-        new_file_path = os_path.abspath(new_file_path) if new_file_path else ''
-        self.log(*args,
-                 sep=sep,
-                 end=end,
-                 level=WARNING,
-                 use_rank=use_rank,
-                 new_file_path=new_file_path)
-
-    def error(self,
-              *args: object,
-              sep: Optional[str] = " ",
-              end: Optional[str] = "\n",
-              use_rank: bool = False,
-              new_file_path: str = None) -> None:
+    def capture_warnings(self, capture: bool = True, dedup: bool = True) -> None:
         """
-        Logs an ERROR level message.
+        Routes Python `warnings` through this logger instead of stderr.
 
-        Args:
-            *args: The message components to be joined and logged.
-            sep: Optional; Separator used to join the components. Default is a space.
-            end: Optional; String appended after the message. Default is newline.
-            use_rank: Optional; If True, include rank information. Default is False.
-            new_file_path: Optional; Write to a new log file if provided.
+        Warnings are logged at WARNING level as `filename:lineno: Category: message`. With
+        `dedup`, only the first warning of each (category, filename, lineno) is logged; the
+        seen locations are kept in a native hash set, so a warning raised in a hot loop costs
+        one lookup after the first time.
 
+        Args:
+            capture (bool): `True` to capture, `False` to restore the previous
+                `warnings.showwarning`. Default is `True`.
+            dedup (bool): Log each warning location only once. Default is `True`.
 
         Example:
-            >>> logger.error("This is a warning message.")
+            >>> logger.capture_warnings()
+            >>> warnings.warn("lr schedule is deprecated", DeprecationWarning)
+            2024-09-18 04:17:23,997 | train | WARNING | train.py:12: DeprecationWarning: lr schedule is deprecated
         """
+        if not capture:
+            if 'showwarning' in _original_hooks:
+                warnings.showwarning = _original_hooks.pop('showwarning')
+            return
 
-        new_file_path = os_path.abspath(new_file_path) if new_file_path else ''
-        self.log(*args,
-                 sep=sep,
-                 end=end,
-                 level=ERROR,
-                 use_rank=use_rank,
-                 new_file_path=new_file_path)
-
-    def critical(self,
-                 *args: object,
-                 sep: Optional[str] = " ",
-                 end: Optional[str] = "\n",
-                 use_rank: bool = False,
-                 new_file_path: str = None) -> None:
+        def showwarning(message, category, filename, lineno, file=None, line=None):
+            self.log_warning(str(message), category.__name__, filename, lineno, dedup)
+
+        _original_hooks.setdefault('showwarning', warnings.showwarning)
+        warnings.showwarning = showwarning
+
+    def install_excepthook(self, install: bool = True, threads: bool = True) -> None:
         """
-        Logs a CRITICAL level message.
+        Logs uncaught exceptions with their traceback at CRITICAL level and flushes every logger.
 
-        Args:
-            *args: The message components to be joined and logged.
-            sep: Optional; Separator used to join the components. Default is a space.
-            end: Optional; String appended after the message. Default is newline.
-            use_rank: Optional; If True, include rank information. Default is False.
-            new_file_path: Optional; Write to a new log file if provided.
+        The hook writes the traceback as one record and then synchronously flushes the files
+        and the console of all live loggers, so the cause of a crash is on disk before the
+        process exits. `KeyboardInterrupt` is passed on to the previous hook.
 
+        Args:
+            install (bool): `True` to install, `False` to restore the previous hooks. Default
+                is `True`.
+            threads (bool): Also handle exceptions escaping `threading.Thread.run` through
+                `threading.excepthook`. Default is `True`.
 
         Example:
-            >>> logger.critical("This is a warning message.")
-        """
-
-        new_file_path = os_path.abspath(new_file_path) if new_file_path else ''
-        self.log(*args,
-                 sep=sep,
-                 end=end,
-                 level=CRITICAL,
-                 use_rank=use_rank,
-                 new_file_path=new_file_path)
+            >>> logger = Logger("train", "train.log")
+            >>> logger.install_excepthook()
+        """
+        if not install:
+            if 'excepthook' in _original_hooks:
+                sys.excepthook = _original_hooks.pop('excepthook')
+            if 'threading_excepthook' in _original_hooks:
+                threading.excepthook = _original_hooks.pop('threading_excepthook')
+            return
+
+        previous = _original_hooks.setdefault('excepthook', sys.excepthook)
+
+        def excepthook(exc_type, exc, tb):
+            if issubclass(exc_type, KeyboardInterrupt) or exc is None:
+                previous(exc_type, exc, tb)
+                return
+            self.log_exception('Uncaught exception:\n', CRITICAL, exc.with_traceback(tb), self.use_rank)
+            flush_all()
+
+        sys.excepthook = excepthook
+        if threads:
+            _original_hooks.setdefault('threading_excepthook', threading.excepthook)
+
+            def threading_excepthook(args):
+                if args.exc_type is SystemExit or args.exc_value is None:
+                    return
+                name = args.thread.name if args.thread is not None else 'unknown'
+                self.log_exception(f'Uncaught exception in thread {name}:\n', CRITICAL,
+                                   args.exc_value.with_traceback(args.exc_traceback), self.use_rank)
+                flush_all()
+
+            threading.excepthook = threading_excepthook
 
     def redirect_print(self) -> None:
         """
@@ -534,7 +678,11 @@ class Logger(CppLogger):
             >>> print("This goes back to the console.")
         """
         self.flush()
-        sys.stdout = self.original_stdout
+        if sys.stdout is self:
+            sys.stdout = self.original_stdout
+        else:
+            # The print router may have replaced this logger as `sys.stdout` since `redirect_print()`
+            _release_print_stream(self, self.original_stdout)
 
     def close(self) -> None:
         """
@@ -560,10 +708,17 @@ class Logger(CppLogger):
         This method allows the Logger to be used as a context manager,
         redirecting all print statements within the 'with' block to the logger.
 
+        Only the calling thread (or asyncio task) is redirected: the logger is bound in a
+        context variable read by a stdout router that is installed once, so entering the
+        block neither replaces `sys.stdout` nor affects prints of other threads.
+
         Returns:
             self: The Logger instance.
         """
-        self.redirect_print()
+        stack = getattr(self._print_tokens, 'stack', None)
+        if stack is None:
+            stack = self._print_tokens.stack = []
+        stack.append(_push_print_target(self))
         return self
 
     def __exit__(self, exc_type, exc_value, traceback):
@@ -577,4 +732,4 @@ class Logger(CppLogger):
             exc_value: The exception value if an exception was raised in the 'with' block.
             traceback: The traceback if an exception was raised in the 'with' block.
         """
-        self.reset_print()
+        _pop_print_target(self._print_tokens.stack.pop())
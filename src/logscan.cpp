@@ -0,0 +1,800 @@
+#include "logscan.h"
+#include "metrics.h"
+
+#include <nanobind/stl/string.h>
+#include <nanobind/stl/tuple.h>
+#include <nanobind/stl/vector.h>
+#include <nanobind/ndarray.h>
+#include <functional>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+    constexpr size_t kChunkSize = 8u << 20; // 8 MiB per task keeps every worker streaming
+
+    /**
+     * @brief Structured filters applied to every candidate line
+     */
+    struct ScanFilter
+    {
+        int min_level = -1;
+        int rank = -1;
+        std::string name;
+        int64_t since = -1;
+        int64_t until = -1;
+
+        [[nodiscard]] bool accepts_fields(const LogLine &line) const
+        {
+            if (min_level >= 0 && line.level < min_level)
+                return false;
+            if (rank >= 0 && line.rank != rank)
+                return false;
+            if (!name.empty() && line.name != name)
+                return false;
+            return true;
+        }
+
+        [[nodiscard]] bool accepts_time(int64_t ts) const
+        {
+            if (since >= 0 && ts < since)
+                return false;
+            if (until >= 0 && ts > until)
+                return false;
+            return true;
+        }
+    };
+
+    struct ScanMatch
+    {
+        int64_t timestamp; // -1 until resolved from an earlier header line
+        uint32_t file;
+        size_t offset;
+        std::string_view line;
+    };
+
+    struct ScanChunk
+    {
+        uint32_t file;
+        size_t base; // offset of the chunk inside its file
+        std::string_view data;
+        int64_t last_timestamp = -1; // timestamp of the last header line in the chunk
+        std::vector<ScanMatch> matches;
+    };
+
+    /**
+     * @brief Timestamp of the closest header line starting in [floor, pos), or -1 if there is none
+     *
+     * `pos` must be the start of a line, so `data[pos - 1]` is the newline closing the previous one.
+     */
+    int64_t preceding_timestamp(std::string_view data, size_t pos, size_t floor = 0)
+    {
+        while (pos > floor)
+        {
+            size_t end = pos - 1;
+            size_t nl = end == 0 ? std::string_view::npos : data.rfind('\n', end - 1);
+            size_t begin = nl == std::string_view::npos ? 0 : nl + 1;
+            if (begin < floor)
+                break;
+            if (int64_t ts = parse_log_line(data.substr(begin, end - begin)).timestamp; ts >= 0)
+                return ts;
+            pos = begin;
+        }
+        return -1;
+    }
+
+    void scan_chunk(ScanChunk &chunk, const std::function<const char *(const char *, const char *)> &find,
+                    const ScanFilter &filter)
+    {
+        const std::string_view data = chunk.data;
+        const char *const first = data.data();
+        const char *const last = first + data.size();
+        const char *cursor = first;
+
+        // Header-less lines take the timestamp of the closest header above them. Only the region
+        // between the previous match and the current one is walked, so the cost stays linear.
+        size_t resolved_until = 0;
+        int64_t resolved_ts = -1;
+
+        while (cursor < last)
+        {
+            // Jump straight to the next candidate: either the next pattern hit or the next line
+            const char *hit = find(cursor, last);
+            if (hit == last)
+                break;
+            const char *line_begin = hit;
+            while (line_begin > cursor && line_begin[-1] != '\n')
+                --line_begin;
+            const void *nl = std::memchr(hit, '\n', static_cast<size_t>(last - hit));
+            const char *line_end = nl ? static_cast<const char *>(nl) : last;
+            cursor = line_end + 1;
+
+            std::string_view text(line_begin, static_cast<size_t>(line_end - line_begin));
+            LogLine fields = parse_log_line(text);
+            if (!filter.accepts_fields(fields))
+                continue;
+
+            size_t offset = static_cast<size_t>(line_begin - first);
+            int64_t ts = fields.timestamp;
+            if (ts < 0)
+            {
+                int64_t above = preceding_timestamp(data, offset, resolved_until);
+                ts = above >= 0 ? above : resolved_ts;
+            }
+            resolved_until = static_cast<size_t>(cursor - first);
+            resolved_ts = ts;
+            chunk.matches.push_back({ts, chunk.file, chunk.base + offset, text});
+        }
+
+        chunk.last_timestamp = preceding_timestamp(data, data.size(), resolved_until);
+        if (chunk.last_timestamp < 0)
+            chunk.last_timestamp = resolved_ts;
+    }
+
+    /**
+     * @brief Scan log files in parallel and return matching lines in timestamp order
+     */
+    std::vector<std::tuple<int64_t, std::string, std::string>>
+    scan_logs(const std::vector<std::string> &paths, const std::string &pattern, int level, int rank,
+              const std::string &name, const std::string &since, const std::string &until, unsigned threads)
+    {
+        ScanFilter filter;
+        filter.min_level = level;
+        filter.rank = rank;
+        filter.name = name;
+        if (!since.empty() && (filter.since = parse_timestamp(since)) < 0)
+            throw std::invalid_argument("Invalid 'since' timestamp: " + since);
+        if (!until.empty() && (filter.until = parse_timestamp(until)) < 0)
+            throw std::invalid_argument("Invalid 'until' timestamp: " + until);
+
+        std::vector<std::unique_ptr<MappedFile>> files;
+        std::vector<ScanChunk> chunks;
+        std::vector<std::tuple<int64_t, std::string, std::string>> results;
+        {
+            nb::gil_scoped_release release;
+
+            for (uint32_t f = 0; f < paths.size(); ++f)
+            {
+                files.push_back(std::make_unique<MappedFile>(paths[f]));
+                const std::string_view data = files.back()->view();
+                for (std::string_view chunk : split_chunks(data, kChunkSize))
+                    chunks.push_back({f, static_cast<size_t>(chunk.data() - data.data()), chunk, -1, {}});
+            }
+
+            // Without a pattern every line is a candidate, so the "search" is the newline scan itself
+            std::function<const char *(const char *, const char *)> find;
+            if (pattern.empty())
+                find = [](const char *first, const char *) { return first; };
+            else
+            {
+                std::boyer_moore_horspool_searcher searcher(pattern.begin(), pattern.end());
+                find = [searcher](const char *first, const char *last) { return searcher(first, last).first; };
+            }
+
+            parallel_for(chunks.size(), threads, [&](size_t i) { scan_chunk(chunks[i], find, filter); });
+
+            // Lines that did not carry a header inherit the timestamp of the previous chunk of the same file
+            std::vector<ScanMatch> matches;
+            int64_t carried = -1;
+            for (size_t i = 0; i < chunks.size(); ++i)
+            {
+                if (i > 0 && chunks[i].file != chunks[i - 1].file)
+                    carried = -1;
+                for (ScanMatch &match : chunks[i].matches)
+                {
+                    if (match.timestamp < 0)
+                        match.timestamp = carried;
+                    if ((filter.since < 0 && filter.until < 0) || (match.timestamp >= 0 && filter.accepts_time(match.timestamp)))
+                        matches.push_back(match);
+                }
+                if (chunks[i].last_timestamp >= 0)
+                    carried = chunks[i].last_timestamp;
+            }
+
+            std::stable_sort(matches.begin(), matches.end(), [](const ScanMatch &a, const ScanMatch &b)
+                             { return a.timestamp != b.timestamp ? a.timestamp < b.timestamp
+                                                                 : (a.file != b.file ? a.file < b.file : a.offset < b.offset); });
+
+            results.reserve(matches.size());
+            for (const ScanMatch &match : matches)
+            {
+                std::string_view line = match.line;
+                if (!line.empty() && line.back() == '\r')
+                    line.remove_suffix(1);
+                results.emplace_back(match.timestamp, paths[match.file], std::string(line));
+            }
+        }
+        return results;
+    }
+
+    /**
+     * @brief Parsed columns of one chunk; names are encoded against a chunk-local dictionary
+     */
+    struct ColumnChunk
+    {
+        uint32_t file;
+        std::string_view data;
+        std::vector<int64_t> timestamp;
+        std::vector<int16_t> level;
+        std::vector<int32_t> rank, world_size, name;
+        std::vector<std::string_view> message;
+        std::vector<std::string_view> local_names;
+        std::unordered_map<std::string_view, int32_t> name_index;
+        size_t message_bytes = 0;
+
+        void parse()
+        {
+            const char *cursor = data.data();
+            const char *const last = cursor + data.size();
+            while (cursor < last)
+            {
+                const void *nl = std::memchr(cursor, '\n', static_cast<size_t>(last - cursor));
+                const char *line_end = nl ? static_cast<const char *>(nl) : last;
+                LogLine fields = parse_log_line(std::string_view(cursor, static_cast<size_t>(line_end - cursor)));
+                cursor = line_end + 1;
+
+                int32_t code = -1;
+                if (fields.timestamp >= 0)
+                {
+                    auto [it, inserted] = name_index.try_emplace(fields.name, static_cast<int32_t>(local_names.size()));
+                    if (inserted)
+                        local_names.push_back(fields.name);
+                    code = it->second;
+                }
+                timestamp.push_back(fields.timestamp);
+                level.push_back(static_cast<int16_t>(fields.level));
+                rank.push_back(fields.rank);
+                world_size.push_back(fields.world_size);
+                name.push_back(code);
+                message.push_back(fields.message);
+                message_bytes += fields.message.size();
+            }
+        }
+    };
+
+    /**
+     * @brief Hand a vector over to NumPy without copying; the array owns the storage
+     */
+    template <typename T>
+    nb::ndarray<nb::numpy, T, nb::ndim<1>> to_numpy(std::vector<T> &&values)
+    {
+        auto *owned = new std::vector<T>(std::move(values));
+        nb::capsule owner(owned, [](void *p) noexcept
+                          { delete static_cast<std::vector<T> *>(p); });
+        size_t shape[1] = {owned->size()};
+        return nb::ndarray<nb::numpy, T, nb::ndim<1>>(owned->data(), 1, shape, owner);
+    }
+
+    /**
+     * @brief Parse whole log files into column arrays, one row per physical line
+     */
+    nb::dict load_columns(const std::vector<std::string> &paths, unsigned threads)
+    {
+        std::vector<std::unique_ptr<MappedFile>> files;
+        std::vector<ColumnChunk> chunks;
+        std::vector<std::string> names;
+        std::vector<int64_t> timestamp, offsets;
+        std::vector<int16_t> level;
+        std::vector<int32_t> rank, world_size, name, file;
+        std::vector<uint8_t> buffer;
+        {
+            nb::gil_scoped_release release;
+
+            for (uint32_t f = 0; f < paths.size(); ++f)
+            {
+                files.push_back(std::make_unique<MappedFile>(paths[f]));
+                for (std::string_view chunk : split_chunks(files.back()->view(), kChunkSize))
+                {
+                    chunks.emplace_back();
+                    chunks.back().file = f;
+                    chunks.back().data = chunk;
+                }
+            }
+
+            parallel_for(chunks.size(), threads, [&](size_t i) { chunks[i].parse(); });
+
+            // Merge the chunk-local name dictionaries and lay out every chunk's slice of the output
+            std::unordered_map<std::string_view, int32_t> global_index;
+            std::vector<std::vector<int32_t>> remap(chunks.size());
+            std::vector<size_t> row_begin(chunks.size() + 1, 0), byte_begin(chunks.size() + 1, 0);
+            for (size_t i = 0; i < chunks.size(); ++i)
+            {
+                for (std::string_view local : chunks[i].local_names)
+                {
+                    auto [it, inserted] = global_index.try_emplace(local, static_cast<int32_t>(names.size()));
+                    if (inserted)
+                        names.emplace_back(local);
+                    remap[i].push_back(it->second);
+                }
+                row_begin[i + 1] = row_begin[i] + chunks[i].timestamp.size();
+                byte_begin[i + 1] = byte_begin[i] + chunks[i].message_bytes;
+            }
+
+            const size_t rows = row_begin.back();
+            timestamp.resize(rows);
+            level.resize(rows);
+            rank.resize(rows);
+            world_size.resize(rows);
+            name.resize(rows);
+            file.resize(rows);
+            offsets.resize(rows + 1);
+            buffer.resize(byte_begin.back());
+            offsets[rows] = static_cast<int64_t>(buffer.size());
+
+            parallel_for(chunks.size(), threads, [&](size_t i)
+                         {
+                ColumnChunk &chunk = chunks[i];
+                const size_t base = row_begin[i];
+                size_t byte = byte_begin[i];
+                std::copy(chunk.timestamp.begin(), chunk.timestamp.end(), timestamp.begin() + base);
+                std::copy(chunk.level.begin(), chunk.level.end(), level.begin() + base);
+                std::copy(chunk.rank.begin(), chunk.rank.end(), rank.begin() + base);
+                std::copy(chunk.world_size.begin(), chunk.world_size.end(), world_size.begin() + base);
+                std::fill(file.begin() + base, file.begin() + base + chunk.timestamp.size(), static_cast<int32_t>(chunk.file));
+                for (size_t r = 0; r < chunk.timestamp.size(); ++r)
+                {
+                    name[base + r] = chunk.name[r] < 0 ? -1 : remap[i][chunk.name[r]];
+                    offsets[base + r] = static_cast<int64_t>(byte);
+                    std::memcpy(buffer.data() + byte, chunk.message[r].data(), chunk.message[r].size());
+                    byte += chunk.message[r].size();
+                }
+                chunk = ColumnChunk{}; });
+        }
+
+        nb::dict result;
+        result["timestamp"] = to_numpy(std::move(timestamp));
+        result["level"] = to_numpy(std::move(level));
+        result["rank"] = to_numpy(std::move(rank));
+        result["world_size"] = to_numpy(std::move(world_size));
+        result["name"] = to_numpy(std::move(name));
+        result["names"] = nb::cast(names);
+        result["file"] = to_numpy(std::move(file));
+        result["paths"] = nb::cast(paths);
+        result["message_offsets"] = to_numpy(std::move(offsets));
+        result["message_buffer"] = to_numpy(std::move(buffer));
+        return result;
+    }
+
+    /**
+     * @brief Parse a floating-point number at `first`, returning the end of it or nullptr
+     */
+    const char *parse_double(const char *first, const char *last, double &value)
+    {
+#if defined(__cpp_lib_to_chars)
+        auto [end, ec] = std::from_chars(first, last, value);
+        return ec == std::errc() ? end : nullptr;
+#else
+        // Floating-point from_chars is missing from older standard libraries; strtod needs a terminated copy
+        char buf[64];
+        size_t n = std::min<size_t>(static_cast<size_t>(last - first), sizeof(buf) - 1);
+        if (n == 0 || !(std::isdigit(static_cast<unsigned char>(*first)) || *first == '-' || *first == '.'))
+            return nullptr;
+        std::memcpy(buf, first, n);
+        buf[n] = '\0';
+        char *end = nullptr;
+        value = std::strtod(buf, &end);
+        return end == buf ? nullptr : first + (end - buf);
+#endif
+    }
+
+    inline bool is_key_start(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+    inline bool is_key_char(char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '/'; }
+    inline bool is_value_end(char c) { return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '|' || c == ')' || c == ']' || c == '\r'; }
+
+    /**
+     * @brief Call `emit(key, value)` for every `key value`, `key=value` or `key: value` pair in `msg`
+     */
+    template <typename Emit>
+    void for_each_numeric_field(std::string_view msg, Emit &&emit)
+    {
+        const char *p = msg.data();
+        const char *const last = p + msg.size();
+        while (p < last)
+        {
+            if (!is_key_start(*p) || (p > msg.data() && is_key_char(p[-1])))
+            {
+                ++p;
+                continue;
+            }
+            const char *key_end = p;
+            while (key_end < last && is_key_char(*key_end))
+                ++key_end;
+            const char *v = key_end;
+            while (v < last && *v == ' ')
+                ++v;
+            if (v < last && (*v == '=' || *v == ':'))
+                ++v;
+            while (v < last && *v == ' ')
+                ++v;
+
+            double value;
+            const char *value_end = v < last ? parse_double(v, last, value) : nullptr;
+            if (value_end && v != key_end && (value_end == last || is_value_end(*value_end)))
+            {
+                emit(std::string_view(p, static_cast<size_t>(key_end - p)), value);
+                p = value_end;
+            }
+            else
+                p = key_end;
+        }
+    }
+
+    /**
+     * @brief Convert a parsed step field, rejecting NaN, infinities and values outside int64
+     */
+    bool to_step(double value, int64_t &step)
+    {
+        // -2^63 and 2^63 are exact doubles; the upper bound itself is out of range
+        if (!std::isfinite(value) || value < -9223372036854775808.0 || value >= 9223372036854775808.0)
+            return false;
+        step = static_cast<int64_t>(value);
+        return true;
+    }
+
+    /**
+     * @brief Numeric samples of one chunk, grouped by a chunk-local key dictionary
+     */
+    struct SeriesChunk
+    {
+        uint32_t file;
+        std::string_view data;
+        bool has_step = false; // a valid step field was seen; `last_step` is meaningless until then
+        int64_t last_step = 0;
+        std::vector<std::string_view> keys;
+        std::unordered_map<std::string_view, uint32_t> key_index;
+        std::vector<size_t> inherited; // per key: leading samples recorded before the first step field
+        std::vector<std::vector<int64_t>> steps;
+        std::vector<std::vector<double>> values;
+
+        void parse(const std::unordered_set<std::string_view> &wanted, const std::string &step_key)
+        {
+            std::vector<std::pair<std::string_view, double>> fields;
+            const char *cursor = data.data();
+            const char *const last = cursor + data.size();
+            while (cursor < last)
+            {
+                const void *nl = std::memchr(cursor, '\n', static_cast<size_t>(last - cursor));
+                const char *line_end = nl ? static_cast<const char *>(nl) : last;
+                std::string_view msg = parse_log_line(std::string_view(cursor, static_cast<size_t>(line_end - cursor))).message;
+                cursor = line_end + 1;
+
+                fields.clear();
+                for_each_numeric_field(msg, [&](std::string_view key, double value)
+                                       {
+                    if (key == step_key)
+                        has_step |= to_step(value, last_step);
+                    else if (wanted.empty() || wanted.count(key))
+                        fields.emplace_back(key, value); });
+
+                for (const auto &[key, value] : fields)
+                {
+                    auto [it, inserted] = key_index.try_emplace(key, static_cast<uint32_t>(keys.size()));
+                    if (inserted)
+                    {
+                        keys.push_back(key);
+                        inherited.push_back(0);
+                        steps.emplace_back();
+                        values.emplace_back();
+                    }
+                    if (!has_step)
+                        ++inherited[it->second]; // its step is the file's step before this chunk
+                    steps[it->second].push_back(last_step);
+                    values[it->second].push_back(value);
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Incrementally pulls numeric series out of growing log files
+     *
+     * Each file remembers how far it has been read and the step in effect at that point,
+     * so calling `update` again only parses lines appended since the previous call.
+     */
+    class CppSeriesExtractor
+    {
+    public:
+        CppSeriesExtractor(const std::vector<std::string> &keys, const std::string &step_key)
+            : wanted_(keys.begin(), keys.end()), step_key_(step_key)
+        {
+            for (const std::string &key : wanted_)
+                wanted_views_.insert(key); // views into the nodes of `wanted_`, which never move
+        }
+
+        /**
+         * @brief Parse the complete lines appended to `paths` since the last call
+         *
+         * @return size_t Number of samples added
+         */
+        size_t update(const std::vector<std::string> &paths, unsigned threads)
+        {
+            nb::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            std::vector<std::unique_ptr<MappedFile>> files;
+            std::vector<FileState *> states;
+            std::vector<SeriesChunk> chunks;
+            for (uint32_t f = 0; f < paths.size(); ++f)
+            {
+                files.push_back(std::make_unique<MappedFile>(paths[f]));
+                FileState &state = files_[paths[f]];
+                states.push_back(&state);
+                std::string_view data = files.back()->view();
+                if (data.size() < state.offset) // truncated or rotated: start over
+                    state = FileState{};
+                data.remove_prefix(state.offset);
+                data = data.substr(0, data.rfind('\n') + 1); // npos + 1 == 0 drops a lone partial line
+                state.offset += data.size();
+                for (std::string_view chunk : split_chunks(data, kChunkSize))
+                {
+                    chunks.emplace_back();
+                    chunks.back().file = f;
+                    chunks.back().data = chunk;
+                }
+            }
+
+            parallel_for(chunks.size(), threads, [&](size_t i) { chunks[i].parse(wanted_views_, step_key_); });
+
+            size_t added = 0;
+            for (SeriesChunk &chunk : chunks)
+            {
+                int64_t &step = states[chunk.file]->step;
+                for (size_t k = 0; k < chunk.keys.size(); ++k)
+                {
+                    auto [it, inserted] = index_.try_emplace(std::string(chunk.keys[k]), names_.size());
+                    if (inserted)
+                    {
+                        names_.push_back(it->first);
+                        steps_.emplace_back();
+                        values_.emplace_back();
+                    }
+                    std::vector<int64_t> &dst_steps = steps_[it->second];
+                    const std::vector<int64_t> &src_steps = chunk.steps[k];
+                    dst_steps.insert(dst_steps.end(), chunk.inherited[k], step);
+                    dst_steps.insert(dst_steps.end(), src_steps.begin() + static_cast<ptrdiff_t>(chunk.inherited[k]), src_steps.end());
+                    std::vector<double> &dst_values = values_[it->second];
+                    dst_values.insert(dst_values.end(), chunk.values[k].begin(), chunk.values[k].end());
+                    added += chunk.values[k].size();
+                }
+                if (chunk.has_step)
+                    step = chunk.last_step;
+            }
+            return added;
+        }
+
+        /**
+         * @brief Copy the collected series out as `{name: (steps int64, values float64)}`
+         */
+        nb::dict series()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            nb::dict result;
+            for (size_t i = 0; i < names_.size(); ++i)
+                result[names_[i].c_str()] = nb::make_tuple(to_numpy(std::vector<int64_t>(steps_[i])),
+                                                           to_numpy(std::vector<double>(values_[i])));
+            return result;
+        }
+
+        /**
+         * @brief Forget collected samples and read positions
+         */
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            files_.clear();
+            index_.clear();
+            names_.clear();
+            steps_.clear();
+            values_.clear();
+        }
+
+    private:
+        struct FileState
+        {
+            size_t offset = 0;
+            int64_t step = -1;
+        };
+
+        std::unordered_set<std::string> wanted_;
+        std::unordered_set<std::string_view> wanted_views_; // looked up per field without building a string
+        std::string step_key_;
+        std::mutex mutex_;
+        std::unordered_map<std::string, FileState> files_;
+        std::unordered_map<std::string, size_t> index_;
+        std::vector<std::string> names_;
+        std::vector<std::vector<int64_t>> steps_;
+        std::vector<std::vector<double>> values_;
+    };
+
+    /**
+     * @brief Load a binary series file written by `CppLogger::log_scalar`
+     */
+    nb::dict read_scalars(const std::string &path)
+    {
+        std::vector<std::string> names;
+        std::vector<std::vector<int64_t>> steps, timestamps;
+        std::vector<std::vector<double>> values;
+        {
+            nb::gil_scoped_release release;
+            MappedFile file(path);
+            if (!file.ok())
+                throw std::runtime_error("Failed to open metrics file: " + path);
+            std::string_view data = file.view();
+            MetricsHeader header{};
+            if (data.size() < sizeof(header))
+                throw std::runtime_error("Not a LightLog metrics file: " + path);
+            std::memcpy(&header, data.data(), sizeof(header));
+            if (std::memcmp(header.magic, kMetricsMagic, sizeof(header.magic)) != 0 ||
+                header.version != kMetricsVersion || header.record_size != sizeof(MetricRecord))
+                throw std::runtime_error("Not a LightLog metrics file: " + path);
+            data.remove_prefix(sizeof(header));
+
+            MappedFile names_file(path + ".names");
+            std::string_view names_data = names_file.view();
+            for (size_t begin = 0; begin < names_data.size();)
+            {
+                size_t end = std::min(names_data.find('\n', begin), names_data.size());
+                names.emplace_back(names_data.substr(begin, end - begin));
+                begin = end + 1;
+            }
+
+            // A writer may be appending right now; ignore a trailing partial record
+            const size_t count = data.size() / sizeof(MetricRecord);
+            std::vector<size_t> sizes(names.size(), 0);
+            MetricRecord record;
+            for (size_t i = 0; i < count; ++i)
+            {
+                std::memcpy(&record, data.data() + i * sizeof(record), sizeof(record));
+                if (record.name_id < sizes.size())
+                    ++sizes[record.name_id];
+            }
+            steps.resize(names.size());
+            timestamps.resize(names.size());
+            values.resize(names.size());
+            for (size_t id = 0; id < names.size(); ++id)
+            {
+                steps[id].reserve(sizes[id]);
+                timestamps[id].reserve(sizes[id]);
+                values[id].reserve(sizes[id]);
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                std::memcpy(&record, data.data() + i * sizeof(record), sizeof(record));
+                if (record.name_id >= names.size())
+                    continue;
+                steps[record.name_id].push_back(record.step);
+                values[record.name_id].push_back(record.value);
+                timestamps[record.name_id].push_back(record.timestamp);
+            }
+        }
+
+        nb::dict result;
+        for (size_t id = 0; id < names.size(); ++id)
+            result[names[id].c_str()] = nb::make_tuple(to_numpy(std::move(steps[id])), to_numpy(std::move(values[id])),
+                                                       to_numpy(std::move(timestamps[id])));
+        return result;
+    }
+}
+
+void init_logscan(nb::module_ &m)
+{
+    m.def("scan_logs", &scan_logs,
+          nb::arg("paths"),
+          nb::arg("pattern") = "",
+          nb::arg("level") = -1,
+          nb::arg("rank") = -1,
+          nb::arg("name") = "",
+          nb::arg("since") = "",
+          nb::arg("until") = "",
+          nb::arg("threads") = 0,
+          R"pbdoc(
+            Scan log files in parallel and return the matching lines in timestamp order.
+
+            Files are memory-mapped and split into newline-aligned chunks that are searched
+            by a pool of threads with the GIL released. Lines are parsed according to the
+            `[rank/world_size] time | name | LEVEL | message` layout written by `CppLogger`.
+
+            Args:
+                paths (list[str]): Log files to scan. Missing files are skipped.
+                pattern (str, optional): Substring that must appear in the line. Defaults to "" (any line).
+                level (int, optional): Minimum log level. Defaults to -1 (no level filtering; header-less
+                    lines are only returned when no level is given).
+                rank (int, optional): Only return lines carrying this rank prefix. Defaults to -1 (any rank).
+                name (str, optional): Only return lines written by this logger name. Defaults to "".
+                since (str, optional): Earliest timestamp, "YYYY-mm-dd[ HH:MM:SS[,mmm]]". Defaults to "".
+                until (str, optional): Latest timestamp, same format as `since`. Defaults to "".
+                threads (int, optional): Number of worker threads. Defaults to 0 (all cores).
+
+            Returns:
+                list[tuple[int, str, str]]: `(timestamp_ms, path, line)` tuples. Lines without a header
+                inherit the timestamp of the closest preceding header line of the same file (-1 if none).
+          )pbdoc");
+
+    m.def("load_columns", &load_columns,
+          nb::arg("paths"),
+          nb::arg("threads") = 0,
+          R"pbdoc(
+            Parse log files into NumPy column arrays, one row per physical line.
+
+            Parsing runs on a pool of threads with the GIL released and creates no per-line
+            Python objects; every array below is handed to NumPy without a copy.
+
+            Args:
+                paths (list[str]): Log files to load, in order. Missing files are skipped.
+                threads (int, optional): Number of worker threads. Defaults to 0 (all cores).
+
+            Returns:
+                dict: Column arrays of equal length (header-less lines hold -1 in the header columns):
+                    - timestamp (int64): Milliseconds since the epoch of the wall-clock reading.
+                    - level (int16): Numeric log level.
+                    - rank, world_size (int32): Values of the `[rank/world_size]` prefix.
+                    - name (int32): Index into `names`.
+                    - names (list[str]): Dictionary of logger names.
+                    - file (int32): Index into `paths`.
+                    - paths (list[str]): The input paths.
+                    - message_offsets (int64): `len + 1` offsets into `message_buffer`; message `i` is
+                      `message_buffer[message_offsets[i]:message_offsets[i + 1]]`.
+                    - message_buffer (uint8): UTF-8 bytes of all messages, back to back.
+          )pbdoc");
+
+    nb::class_<CppSeriesExtractor>(m, "CppSeriesExtractor")
+        .def(nb::init<const std::vector<std::string> &, const std::string &>(),
+             nb::arg("keys") = std::vector<std::string>(),
+             nb::arg("step_key") = "step",
+             R"pbdoc(
+                Initialize a new numeric series extractor.
+
+                Args:
+                    keys (list[str], optional): Field names to extract. Defaults to [] (every numeric field).
+                    step_key (str, optional): Field that sets the step of the following samples. Defaults to "step".
+
+                Fields are recognized in the `key value`, `key=value` and `key: value` forms, e.g. the line
+                `step 1200 loss 0.31 lr=3e-4` yields `loss` and `lr` samples at step 1200. Samples that
+                appear before any step field in a file get step -1.
+             )pbdoc")
+        .def("update", &CppSeriesExtractor::update,
+             nb::arg("paths"),
+             nb::arg("threads") = 0,
+             R"pbdoc(
+                 Parse the complete lines appended to the given files since the last call.
+
+                 Args:
+                     paths (list[str]): Log files to read. A file that shrank is read again from the start.
+                     threads (int, optional): Number of worker threads. Defaults to 0 (all cores).
+
+                 Returns:
+                     int: The number of samples added.
+             )pbdoc")
+        .def("series", &CppSeriesExtractor::series,
+             R"pbdoc(
+                 Return the collected samples as `{name: (steps, values)}` with int64 steps and float64 values.
+             )pbdoc")
+        .def("clear", &CppSeriesExtractor::clear,
+             R"pbdoc(
+                 Forget all collected samples and read positions.
+             )pbdoc");
+
+    m.def("read_scalars", &read_scalars,
+          nb::arg("path"),
+          R"pbdoc(
+            Load a binary series file written by `CppLogger.log_scalar`.
+
+            Args:
+                path (str): Path of the series file (the ".names" dictionary must sit next to it).
+
+            Returns:
+                dict: `{name: (steps, values, timestamps)}` with int64 steps, float64 values and
+                int64 timestamps in nanoseconds since the epoch, in logging order.
+
+            Raises:
+                RuntimeError: If the file cannot be opened or is not a metrics file.
+          )pbdoc");
+}
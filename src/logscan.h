@@ -0,0 +1,287 @@
+#pragma once
+
+#include <nanobind/nanobind.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "levels.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nb = nanobind;
+
+/**
+ * @brief Read-only memory mapping of a whole log file
+ *
+ * Empty or unreadable files map to an empty view; `ok()` tells the two apart.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string &path)
+    {
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                            nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE)
+            return;
+        LARGE_INTEGER size;
+        ok_ = GetFileSizeEx(file_, &size) != 0;
+        if (!ok_ || size.QuadPart == 0)
+            return;
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ != nullptr)
+            data_ = static_cast<const char *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        size_ = data_ ? static_cast<size_t>(size.QuadPart) : 0;
+        ok_ = data_ != nullptr;
+#else
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            return;
+        struct stat st;
+        ok_ = ::fstat(fd_, &st) == 0;
+        if (!ok_ || st.st_size == 0)
+            return;
+        void *p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED)
+        {
+            ok_ = false;
+            return;
+        }
+        ::madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(p);
+        size_ = static_cast<size_t>(st.st_size);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (data_)
+            UnmapViewOfFile(data_);
+        if (mapping_ != nullptr)
+            CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE)
+            CloseHandle(file_);
+#else
+        if (data_)
+            ::munmap(const_cast<char *>(data_), size_);
+        if (fd_ >= 0)
+            ::close(fd_);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    [[nodiscard]] bool ok() const { return ok_; }
+    [[nodiscard]] std::string_view view() const { return {data_, size_}; }
+
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    bool ok_ = false;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+/**
+ * @brief Fields of one line in the `[rank/world] time | name | LEVEL | msg` layout
+ *
+ * Lines logged at NOTSET carry no header; for those `timestamp` and `level` stay -1
+ * and `message` is the whole line (after the optional rank prefix).
+ */
+struct LogLine
+{
+    int rank = -1;
+    int world_size = -1;
+    int64_t timestamp = -1; // milliseconds since the epoch of the (local) wall-clock reading
+    int level = -1;
+    std::string_view name;
+    std::string_view message;
+};
+
+/**
+ * @brief Parse a non-negative decimal integer of exactly `n` digits
+ */
+inline bool parse_fixed_digits(const char *p, size_t n, int &out)
+{
+    int v = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (p[i] < '0' || p[i] > '9')
+            return false;
+        v = v * 10 + (p[i] - '0');
+    }
+    out = v;
+    return true;
+}
+
+/**
+ * @brief Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's algorithm)
+ */
+inline int64_t days_from_civil(int y, int m, int d)
+{
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief Parse the `YYYY-mm-dd HH:MM:SS,mmm` stamp written by `format_message`
+ *
+ * @param s Text starting with the stamp; the time and millisecond parts are optional
+ *          so the same function can parse user-supplied range bounds
+ * @param consumed Number of characters that made up the stamp
+ * @return int64_t Milliseconds since the epoch, or -1 if `s` does not start with a stamp
+ */
+inline int64_t parse_timestamp(std::string_view s, size_t *consumed = nullptr)
+{
+    int y, mo, d, h = 0, mi = 0, sec = 0, ms = 0;
+    if (s.size() < 10 || s[4] != '-' || s[7] != '-' ||
+        !parse_fixed_digits(s.data(), 4, y) || !parse_fixed_digits(s.data() + 5, 2, mo) ||
+        !parse_fixed_digits(s.data() + 8, 2, d))
+        return -1;
+    size_t n = 10;
+    if (s.size() >= 19 && (s[10] == ' ' || s[10] == 'T') && s[13] == ':' && s[16] == ':' &&
+        parse_fixed_digits(s.data() + 11, 2, h) && parse_fixed_digits(s.data() + 14, 2, mi) &&
+        parse_fixed_digits(s.data() + 17, 2, sec))
+    {
+        n = 19;
+        if (s.size() >= 23 && (s[19] == ',' || s[19] == '.') && parse_fixed_digits(s.data() + 20, 3, ms))
+            n = 23;
+    }
+    if (consumed)
+        *consumed = n;
+    return ((days_from_civil(y, mo, d) * 24 + h) * 60 + mi) * 60000 + sec * 1000 + ms;
+}
+
+/**
+ * @brief Map a rendered level name back to its numeric value (-1 if unknown)
+ */
+inline int level_from_name(std::string_view name) { return LevelRegistry::value(name); }
+
+/**
+ * @brief Split one line (without its newline) into its structured fields
+ *
+ * Never fails: lines that do not follow the layout are reported as header-less messages.
+ */
+inline LogLine parse_log_line(std::string_view line)
+{
+    LogLine out;
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    // Optional "[rank/world_size] " prefix
+    if (line.size() > 5 && line[0] == '[')
+    {
+        size_t slash = line.find('/', 1);
+        size_t close = line.find("] ", 1);
+        if (slash != std::string_view::npos && close != std::string_view::npos && slash < close)
+        {
+            int r, w;
+            if (slash > 1 && close > slash + 1 && parse_fixed_digits(line.data() + 1, slash - 1, r) &&
+                parse_fixed_digits(line.data() + slash + 1, close - slash - 1, w))
+            {
+                out.rank = r;
+                out.world_size = w;
+                line.remove_prefix(close + 2);
+            }
+        }
+    }
+    out.message = line;
+
+    size_t n = 0;
+    int64_t ts = parse_timestamp(line, &n);
+    if (ts < 0 || n != 23 || line.compare(n, 3, " | ") != 0)
+        return out;
+    std::string_view rest = line.substr(n + 3);
+    size_t name_end = rest.find(" | ");
+    if (name_end == std::string_view::npos)
+        return out;
+    size_t level_end = rest.find(" | ", name_end + 3);
+    if (level_end == std::string_view::npos)
+        return out;
+
+    out.timestamp = ts;
+    out.name = rest.substr(0, name_end);
+    out.level = level_from_name(rest.substr(name_end + 3, level_end - name_end - 3));
+    out.message = rest.substr(level_end + 3);
+    return out;
+}
+
+/**
+ * @brief Split a buffer into newline-aligned chunks of roughly `chunk_size` bytes
+ */
+inline std::vector<std::string_view> split_chunks(std::string_view data, size_t chunk_size)
+{
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    while (begin < data.size())
+    {
+        size_t end = std::min(data.size(), begin + chunk_size);
+        if (end < data.size())
+        {
+            const void *nl = std::memchr(data.data() + end, '\n', data.size() - end);
+            end = nl ? static_cast<size_t>(static_cast<const char *>(nl) - data.data()) + 1 : data.size();
+        }
+        chunks.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+/**
+ * @brief Run `fn(i)` for every i in [0, n) on up to `threads` threads (0 = hardware concurrency)
+ *
+ * Tasks are handed out through a shared counter so uneven chunks balance themselves.
+ */
+inline void parallel_for(size_t n, unsigned threads, const std::function<void(size_t)> &fn)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, n));
+    std::atomic<size_t> next{0};
+    auto worker = [&]()
+    {
+        for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < n; i = next.fetch_add(1, std::memory_order_relaxed))
+            fn(i);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    if (threads > 0)
+        worker();
+    for (auto &th : pool)
+        th.join();
+}
+
+/**
+ * @brief Register the log scanning functions on the extension module
+ */
+void init_logscan(nb::module_ &m);
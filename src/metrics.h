@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief On-disk layout of the binary scalar series written by `CppLogger::log_scalar`
+ *
+ * A series is stored as two files next to each other:
+ *  - `<path>`: a `MetricsHeader` followed by fixed-width `MetricRecord`s, in logging order
+ *  - `<path>.names`: the name dictionary, one name per line; line i holds the name of id i
+ *
+ * Records are little-endian native structs, so the data file can be memory-mapped directly,
+ * e.g. `numpy.memmap(path, dtype=[("name", "<u4"), ("pad", "<u4"), ("step", "<i8"),
+ * ("value", "<f8"), ("timestamp", "<i8")], offset=16)`.
+ */
+struct MetricsHeader
+{
+    char magic[8];          // "LLMETRIC"
+    uint32_t version;       // kMetricsVersion
+    uint32_t record_size;   // sizeof(MetricRecord)
+};
+
+struct MetricRecord
+{
+    uint32_t name_id;  // line number in the `.names` dictionary
+    uint32_t reserved; // keeps the 8-byte fields aligned; always 0
+    int64_t step;
+    double value;
+    int64_t timestamp; // nanoseconds since the epoch
+};
+
+static_assert(sizeof(MetricsHeader) == 16, "MetricsHeader must stay 16 bytes");
+static_assert(sizeof(MetricRecord) == 32, "MetricRecord must stay 32 bytes");
+
+inline constexpr char kMetricsMagic[8] = {'L', 'L', 'M', 'E', 'T', 'R', 'I', 'C'};
+inline constexpr uint32_t kMetricsVersion = 1;
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+/**
+ * @brief How the memory of large rings is backed
+ */
+enum class HugePages
+{
+    kOff,         // regular pages
+    kTransparent, // regular mapping, advised for transparent huge pages (Linux)
+    kExplicit,    // reserved huge pages (MAP_HUGETLB, MEM_LARGE_PAGES), else as kTransparent
+};
+
+/**
+ * @brief Page-aligned anonymous memory for queue rings, optionally backed by huge pages
+ *
+ * The pages come straight from the OS and are not touched here, so under the default NUMA
+ * policy each one lands on the node of the thread that first writes to it; the owner decides
+ * placement by choosing which thread initializes the ring.
+ */
+class RingMemory
+{
+public:
+    static constexpr size_t kHugePageSize = size_t(2) << 20;
+
+    RingMemory() = default;
+
+    /**
+     * @throws std::bad_alloc if the OS has no memory left
+     */
+    RingMemory(size_t bytes, HugePages huge_pages)
+    {
+#ifdef _WIN32
+        if (huge_pages == HugePages::kExplicit)
+        {
+            // Needs the "Lock pages in memory" privilege; without it the call fails and regular pages are used
+            if (const size_t large = GetLargePageMinimum())
+            {
+                size_ = (bytes + large - 1) / large * large;
+                data_ = VirtualAlloc(nullptr, size_, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            }
+        }
+        if (!data_)
+        {
+            size_ = bytes;
+            data_ = VirtualAlloc(nullptr, size_, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        }
+        if (!data_)
+            throw std::bad_alloc();
+#else
+        size_ = huge_pages == HugePages::kOff ? bytes : (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        void *data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if (huge_pages == HugePages::kExplicit)
+            data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (data == MAP_FAILED)
+        {
+            data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (data == MAP_FAILED)
+                throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+            if (huge_pages != HugePages::kOff)
+                madvise(data, size_, MADV_HUGEPAGE); // only advice: ignored where THP is disabled
+#endif
+        }
+        data_ = data;
+#endif
+    }
+
+    ~RingMemory()
+    {
+        if (!data_)
+            return;
+#ifdef _WIN32
+        VirtualFree(data_, 0, MEM_RELEASE);
+#else
+        munmap(data_, size_);
+#endif
+    }
+
+    RingMemory(RingMemory &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+    RingMemory &operator=(RingMemory &&other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    [[nodiscard]] void *data() const { return data_; }
+    [[nodiscard]] size_t size() const { return size_; }
+
+    /**
+     * @throws std::invalid_argument unless `name` is "off", "transparent" or "explicit"
+     */
+    static HugePages parse(const std::string &name)
+    {
+        if (name == "off")
+            return HugePages::kOff;
+        if (name == "transparent")
+            return HugePages::kTransparent;
+        if (name == "explicit")
+            return HugePages::kExplicit;
+        throw std::invalid_argument("huge_pages must be 'off', 'transparent' or 'explicit', got '" + name + "'");
+    }
+
+private:
+    void *data_ = nullptr;
+    size_t size_ = 0;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#ifdef __APPLE__
+#include <pthread/qos.h>
+#endif
+#endif
+
+/**
+ * @brief CPU placement and scheduling of the library's own background threads
+ *
+ * Set once per process (see `configure_engine`) and applied by each internal thread to
+ * itself when it starts, so writer threads stay off the cores of pinned compute threads and
+ * yield to them. Settings a platform cannot express are ignored: affinity is not available
+ * on macOS, where `idle` and a positive `nice` map to the background and utility QoS classes.
+ */
+struct ThreadPolicy
+{
+    std::vector<int> cpus; // allowed CPUs, empty for any
+    int nice = 0;          // -20 (highest) to 19 (lowest)
+    bool idle = false;     // run only when a CPU has nothing else to do (SCHED_IDLE on Linux)
+
+    bool operator==(const ThreadPolicy &other) const
+    {
+        return cpus == other.cpus && nice == other.nice && idle == other.idle;
+    }
+    bool operator!=(const ThreadPolicy &other) const { return !(*this == other); }
+
+    /**
+     * @throws std::invalid_argument for negative or too large CPU indices and `nice` outside [-20, 19]
+     */
+    void validate() const
+    {
+        for (int cpu : cpus)
+        {
+            if (cpu < 0 || cpu >= kMaxCpus)
+                throw std::invalid_argument("CPU index out of range: " + std::to_string(cpu));
+        }
+        if (nice < -20 || nice > 19)
+            throw std::invalid_argument("nice must be between -20 and 19, got " + std::to_string(nice));
+    }
+
+    /**
+     * @brief The policy of the internal threads started from now on
+     */
+    static ThreadPolicy current()
+    {
+        std::lock_guard<std::mutex> lock(mutex());
+        return policy();
+    }
+
+    static void set(ThreadPolicy value)
+    {
+        value.validate();
+        std::lock_guard<std::mutex> lock(mutex());
+        policy() = std::move(value);
+    }
+
+    /**
+     * @brief Apply the current policy to the calling thread, reporting what the OS refused on stderr
+     */
+    static void apply_current(const char *thread_name) { current().apply(thread_name); }
+
+    void apply(const char *thread_name) const
+    {
+        auto refused = [thread_name](const char *what)
+        { std::cerr << "lightlog: cannot set " << what << " of the " << thread_name << " thread" << std::endl; };
+#if defined(__linux__)
+        if (!cpus.empty())
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpus)
+                CPU_SET(cpu, &set);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+                refused("the CPU affinity");
+        }
+        if (idle)
+        {
+            sched_param param{};
+            if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) != 0)
+                refused("SCHED_IDLE");
+        }
+        // Linux applies the nice value of PRIO_PROCESS to a single thread when given its id
+        if (nice != 0 && setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), nice) != 0)
+            refused("the nice value");
+#elif defined(__APPLE__)
+        if (idle || nice > 0)
+        {
+            if (pthread_set_qos_class_self_np(idle ? QOS_CLASS_BACKGROUND : QOS_CLASS_UTILITY, 0) != 0)
+                refused("the QoS class");
+        }
+#elif defined(_WIN32)
+        if (!cpus.empty())
+        {
+            DWORD_PTR mask = 0;
+            for (int cpu : cpus)
+            {
+                if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8))
+                    mask |= DWORD_PTR(1) << cpu;
+            }
+            if (!mask || !SetThreadAffinityMask(GetCurrentThread(), mask))
+                refused("the CPU affinity");
+        }
+        if (idle || nice != 0)
+        {
+            const int priority = idle        ? THREAD_PRIORITY_IDLE
+                                 : nice >= 10 ? THREAD_PRIORITY_LOWEST
+                                 : nice > 0   ? THREAD_PRIORITY_BELOW_NORMAL
+                                 : nice > -10 ? THREAD_PRIORITY_ABOVE_NORMAL
+                                              : THREAD_PRIORITY_HIGHEST;
+            if (!SetThreadPriority(GetCurrentThread(), priority))
+                refused("the priority");
+        }
+#else
+        (void)refused;
+#endif
+    }
+
+private:
+    static constexpr int kMaxCpus = 1024; // CPU_SETSIZE of glibc
+
+    // Both leaked, so threads may still start during interpreter teardown
+    static ThreadPolicy &policy()
+    {
+        static auto *policy = new ThreadPolicy();
+        return *policy;
+    }
+
+    static std::mutex &mutex()
+    {
+        static auto *mutex = new std::mutex();
+        return *mutex;
+    }
+};